@@ -108,8 +108,11 @@ void printStatus(void)
   // print time
   Serial.print(millis()); Serial.println("ms");
   
+  // get and reset latched error atomically. Errors latched meanwhile by the LIN handlers are not lost
+  LIN_error_t error = LIN_master3.clearError();
+
   // LIN ok -> print received data
-  if (LIN_master3.error == LIN_SUCCESS)
+  if (error == LIN_SUCCESS)
   {
     for (uint8_t i=0; i<8; i++)
     {
@@ -120,24 +123,23 @@ void printStatus(void)
   // print LIN error status
   else {
     Serial.print("LIN error (0x");
-    Serial.print(LIN_master3.error, HEX);
+    Serial.print(error, HEX);
     Serial.print("): ");
-    if (LIN_master3.error & LIN_ERROR_STATE)
+    if (error & LIN_ERROR_STATE)
       Serial.println("statemachine");
-    else if (LIN_master3.error & LIN_ERROR_ECHO)
+    else if (error & LIN_ERROR_ECHO)
       Serial.println("echo");
-    else if (LIN_master3.error & LIN_ERROR_TIMEOUT)
+    else if (error & LIN_ERROR_TIMEOUT)
       Serial.println("timeout");
-    else if (LIN_master3.error & LIN_ERROR_CHK)
+    else if (error & LIN_ERROR_CHK)
       Serial.println("checksum");
-    else if (LIN_master3.error & LIN_ERROR_MISC)
+    else if (error & LIN_ERROR_MISC)
       Serial.println("misc");
   } // error
 
   Serial.println();
 
-  // reset latched error and flag for data received
-  LIN_master3.error = LIN_SUCCESS;
+  // reset flag for data received
   LIN_master3.flagRxComplete = false;
   
 } // printStatus()
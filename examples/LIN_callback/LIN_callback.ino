@@ -189,8 +189,11 @@ void statusDecode(uint8_t numData, uint8_t *data)
 // print slave response signals. Periodically called by task scheduler
 void printStatus(void)
 {
+  // get and reset latched error atomically. Errors latched meanwhile by the LIN handlers are not lost
+  LIN_error_t error = LIN_master3.clearError();
+
   // LIN ok -> print some slave data
-  if (LIN_master3.error == LIN_SUCCESS)
+  if (error == LIN_SUCCESS)
   {
     Serial.print("set speed: "); Serial.print(CoolFan_RPM_Ack*25);      Serial.println("rpm");
     Serial.print("act speed: "); Serial.print(CoolFan_RPM_Avg*25);      Serial.println("rpm");
@@ -204,30 +207,29 @@ void printStatus(void)
   // print LIN error status
   else {
     Serial.print("LIN error (0x");
-    Serial.print(LIN_master3.error, HEX);
+    Serial.print(error, HEX);
     Serial.print("): ");
 
-    if (LIN_master3.error & LIN_ERROR_STATE)
+    if (error & LIN_ERROR_STATE)
       Serial.print("statemachine ");
     
-    if (LIN_master3.error & LIN_ERROR_ECHO)
+    if (error & LIN_ERROR_ECHO)
       Serial.print("echo ");
     
-    if (LIN_master3.error & LIN_ERROR_TIMEOUT)
+    if (error & LIN_ERROR_TIMEOUT)
       Serial.print("timeout ");
     
-    if (LIN_master3.error & LIN_ERROR_CHK)
+    if (error & LIN_ERROR_CHK)
       Serial.print("checksum ");
     
-    if (LIN_master3.error & LIN_ERROR_MISC)
+    if (error & LIN_ERROR_MISC)
       Serial.print("misc ");
 
     Serial.println();
 
   } // error
 
-  // reset latched error and flag for data received
-  LIN_master3.error = LIN_SUCCESS;
+  // reset flag for data received
   LIN_master3.flagRxComplete = false;
   
 } // printStatus()
@@ -0,0 +1,102 @@
+/**
+  \file     LIN_gateway.ino
+  \example  LIN_gateway.ino
+  \brief    LIN-to-CAN gateway with virtual CAN
+  \details  Gateway between LIN via Serial1 and a virtual CAN bus. Slave responses of ID 0x1B are forwarded
+            to CAN ID 0x100, CAN messages with ID 0x200 are sent as master request ID 0x3B. The other side of
+            the virtual CAN bus is emulated in loop(). For real CAN replace LIN_CAN_Virtual by LIN_CAN_MCP2515.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+
+  \note 
+  The sender state machine relies on reading back its 1-wire echo. 
+  If no LIN or K-Line transceiver is used, connect Rx&Tx (only 1 device!) 
+*/
+
+// include files
+#include "LIN_master1.h"
+#include "LIN_gateway.h"
+#include "Tasks.h"
+
+// task scheduler periods [ms]
+#define LIN_PERIOD    10      // LIN frame every N ms
+
+
+// virtual CAN bus with gateway side and emulated remote node
+LIN_CAN_Virtual  canGateway;
+LIN_CAN_Virtual  canRemote;
+
+// gateway routing table
+LIN_gateway_route_t  routes[] = {
+  { 0x1B, 0x100, 8, LIN_TO_CAN },
+  { 0x3B, 0x200, 2, CAN_TO_LIN }
+};
+
+// gateway between LIN_master1 and virtual CAN
+LIN_Gateway  gateway(LIN_master1, canGateway, routes, 2);
+
+
+
+void setup(void)
+{
+  // for user interaction via console
+  Serial.begin(115200); while(!Serial);
+
+  // connect virtual CAN nodes
+  canGateway.connect(canRemote);
+
+  // initialize LIN master (background operation) and gateway
+  LIN_master1.begin(19200, LIN_V2, true);
+  gateway.begin();
+  
+  // init task scheduler (also required for LIN master emulation!)
+  Tasks_Init();
+  Tasks_Add((Task) LIN_scheduler, LIN_PERIOD, 0);
+  Tasks_Start();
+
+} // setup()
+
+
+
+void loop(void)
+{
+  static uint8_t     count = 0;
+  LIN_CAN_message_t  msg;
+
+  // forward pending CAN messages
+  gateway.task();
+
+  // print messages received by remote CAN node
+  while (canRemote.receive(msg))
+  {
+    Serial.print("CAN 0x");
+    Serial.print(msg.id, HEX);
+    for (uint8_t i=0; i<msg.len; i++)
+    {
+      Serial.print(" 0x");
+      Serial.print(msg.data[i], HEX);
+    }
+    Serial.println();
+
+    // reply with new data for LIN master request
+    msg.id      = 0x200;
+    msg.len     = 2;
+    msg.data[0] = count++;
+    msg.data[1] = 0x00;
+    canRemote.send(msg);
+  }
+  
+} // loop()
+
+
+
+// actual LIN scheduler. Periodically called by task scheduler
+void LIN_scheduler(void)
+{
+  static uint8_t  slot = 0;
+
+  // execute LIN frame of next route
+  gateway.handleSlot(slot);
+  slot = (slot + 1) % 2;
+  
+} // LIN_scheduler()
@@ -0,0 +1,102 @@
+/**
+  \file     LIN_schedule.ino
+  \example  LIN_schedule.ino
+  \brief    LIN schedule table with interleaved diagnostics
+  \details  Emulation of a LIN master node via Serial1 with a schedule table. Every second a diagnostic
+            ReadByIdentifier request is interleaved into the running schedule, every 4th slot is a diagnostic slot.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+
+  \note 
+  The sender state machine relies on reading back its 1-wire echo. 
+  If no LIN or K-Line transceiver is used, connect Rx&Tx (only 1 device!) 
+*/
+
+// include files
+#include "LIN_master1.h"
+#include "LIN_schedule.h"
+#include "Tasks.h"
+
+// task scheduler periods [ms]
+#define LIN_PERIOD    10      // LIN slot every N ms
+#define DIAG_PERIOD   1000    // diagnostic request every N ms
+
+
+// application frame data
+uint8_t  dataRequest[2]  = { 0x00, 0x00 };
+uint8_t  dataResponse[8];
+
+// application schedule table
+const LIN_schedule_entry_t  table[] = {
+  { LIN_MASTER_REQUEST, 0x3B, 2, dataRequest,  NULL },
+  { LIN_SLAVE_RESPONSE, 0x1B, 8, dataResponse, NULL }
+};
+
+// schedule for LIN_master1
+LIN_Schedule  schedule(LIN_master1);
+
+
+
+void setup(void)
+{
+  // for user interaction via console
+  Serial.begin(115200); while(!Serial);
+
+  // initialize LIN master (background operation)
+  LIN_master1.begin(19200, LIN_V2, true);
+
+  // set schedule table and 3 application slots per diagnostic slot
+  schedule.setTable(table, 2);
+  schedule.setDiagnosticRatio(3);
+  
+  // init task scheduler (also required for LIN master emulation!)
+  Tasks_Init();
+  Tasks_Add((Task) LIN_tick, LIN_PERIOD, 0);
+  Tasks_Add((Task) readIdentifier, DIAG_PERIOD, DIAG_PERIOD);
+  Tasks_Start();
+
+} // setup()
+
+
+
+void loop(void)
+{
+  
+} // loop()
+
+
+
+// execute next LIN slot. Periodically called by task scheduler
+void LIN_tick(void)
+{
+  schedule.tick();
+  
+} // LIN_tick()
+
+
+
+// queue diagnostic request. Periodically called by task scheduler
+void readIdentifier(void)
+{
+  // ReadByIdentifier (product ID) to all NADs, wildcard supplier & function ID
+  const uint8_t  request[8] = { 0x7F, 0x06, 0xB2, 0x00, 0xFF, 0x7F, 0xFF, 0xFF };
+
+  // queue request and response
+  schedule.queueDiagnostic(request, NULL, printResponse);
+  
+} // readIdentifier()
+
+
+
+// print diagnostic response
+void printResponse(uint8_t numData, uint8_t *data)
+{
+  Serial.print("diag:");
+  for (uint8_t i=0; i<numData; i++)
+  {
+    Serial.print(" 0x");
+    Serial.print(data[i], HEX);
+  }
+  Serial.println();
+  
+} // printResponse()
@@ -0,0 +1,222 @@
+/**
+  \file     LIN_arbiter.cpp
+  \brief    Weighted fair arbitration of ad-hoc frames from several clients
+  \details  This library queues ad-hoc frames of several clients (e.g. test modules sharing one LIN_Master) per client
+            and passes them to the background queue of a LIN_Schedule via deficit round robin, i.e. each client gets
+            a share of the idle bus time proportional to its weight. Queue wait time is tracked per client.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_arbiter.h"
+
+
+/**
+  \brief      Constructor for arbiter
+  \details    Constructor for arbiter. Initially no client is registered.
+  \param[in]  Schedule    schedule of LIN master. Requires a slot time, see LIN_Schedule::setSlotTime()
+*/
+LIN_Arbiter::LIN_Arbiter(LIN_Schedule &Schedule)
+{
+  pSchedule = &Schedule;
+  numClient = 0;
+  current   = 0;
+  newTurn   = true;
+  for (uint8_t i=0; i<LIN_ARBITER_CLIENTS; i++)
+    client[i].weight = 0;
+
+} // LIN_Arbiter::LIN_Arbiter()
+
+
+
+/**
+  \brief      Add client
+  \details    Register a client with its share of idle bus time.
+  \param[in]  Weight      relative share of bus time (1..255)
+  \return     client ID, or -1 if LIN_ARBITER_CLIENTS clients are registered
+*/
+int8_t LIN_Arbiter::addClient(uint8_t Weight)
+{
+  LIN_arbiter_client_t  *c;
+
+  if (numClient >= LIN_ARBITER_CLIENTS)
+    return -1;
+
+  // init client. Activate last, task() may run concurrently
+  c = &(client[numClient]);
+  c->deficit     = 0;
+  c->head        = 0;
+  c->num         = 0;
+  c->numSent     = 0;
+  c->numRejected = 0;
+  c->maxWait     = 0;
+  c->wait.reset();
+  c->weight      = (Weight == 0) ? 1 : Weight;
+  numClient++;
+
+  return numClient-1;
+
+} // LIN_Arbiter::addClient()
+
+
+
+/**
+  \brief      Queue frame of client
+  \details    Queue an ad-hoc frame of a client. Instead of colliding with frames of other clients, it is sent when
+              the arbiter serves this client and the schedule has idle time.
+  \param[in]  Client      client ID, see addClient()
+  \param[in]  Frame       frame to send. Data buffer must remain valid until the frame is sent
+  \return     false if client is invalid or its queue is full
+*/
+bool LIN_Arbiter::submit(uint8_t Client, const LIN_schedule_entry_t &Frame)
+{
+  LIN_arbiter_client_t  *c;
+  LIN_irq_t             s;
+
+  if (Client >= numClient)
+    return false;
+  c = &(client[Client]);
+
+  // queue frame with timestamp. Avoid race with task()
+  s = LIN_irqSave();
+  if (c->num >= LIN_ARBITER_DEPTH)
+  {
+    c->numRejected++;
+    LIN_irqRestore(s);
+    return false;
+  }
+  c->queue[c->head]   = Frame;
+  c->tSubmit[c->head] = micros();
+  c->head = (c->head + 1) % LIN_ARBITER_DEPTH;
+  c->num++;
+  LIN_irqRestore(s);
+
+  return true;
+
+} // LIN_Arbiter::submit()
+
+
+
+/**
+  \brief      Get number of queued frames
+  \details    Get number of frames of a client which are not yet passed to the schedule.
+  \param[in]  Client      client ID
+  \return     number of queued frames
+*/
+uint8_t LIN_Arbiter::pending(uint8_t Client)
+{
+  return (Client < numClient) ? client[Client].num : 0;
+
+} // LIN_Arbiter::pending()
+
+
+
+/**
+  \brief      Pass next frame to schedule
+  \details    If the background queue of the schedule is empty, pass the next frame by deficit round robin.
+              The current client may send while its deficit covers the frame length, then the next client
+              gets weight*LIN_ARBITER_QUANTUM bytes. Idle clients don't accumulate deficit. A frame rejected by
+              the schedule stays queued. The recorded wait time ends when the frame is passed to the schedule.
+  \return     true if a frame was passed to the schedule
+*/
+bool LIN_Arbiter::task(void)
+{
+  LIN_arbiter_client_t  *c;
+  uint8_t               tail, cost;
+  uint32_t              wait;
+  LIN_irq_t             s;
+
+  // pass only one frame at a time, so later submits are still arbitrated
+  if ((numClient == 0) || (pSchedule->backgroundPending()))
+    return false;
+
+  // quantum exceeds max. frame length, i.e. one round over all clients suffices
+  s = LIN_irqSave();
+  for (uint8_t n=0; n<=numClient; n++)
+  {
+    c = &(client[current]);
+
+    // idle client -> skip w/o deficit
+    if (c->num == 0)
+    {
+      c->deficit = 0;
+      current    = (current + 1) % numClient;
+      newTurn    = true;
+      continue;
+    }
+
+    // start of turn -> add quantum
+    if (newTurn)
+    {
+      c->deficit += (uint16_t) c->weight * LIN_ARBITER_QUANTUM;
+      newTurn     = false;
+    }
+
+    // deficit covers frame -> dequeue and pass to schedule
+    tail = (c->head + LIN_ARBITER_DEPTH - c->num) % LIN_ARBITER_DEPTH;
+    cost = c->queue[tail].numData + 3;
+    if (c->deficit >= cost)
+    {
+      // schedule queue was filled by another producer meanwhile -> keep frame and retry in next call
+      if (!pSchedule->queueBackground(c->queue[tail]))
+      {
+        LIN_irqRestore(s);
+        return false;
+      }
+      wait        = micros() - c->tSubmit[tail];
+      c->deficit -= cost;
+      c->num--;
+      LIN_irqRestore(s);
+
+      // frame accepted by schedule. Wait time excludes schedule queue and frame duration
+      c->numSent++;
+      c->wait.add((wait > 0xFFFF) ? 0xFFFF : (uint16_t) wait);
+      if (wait > c->maxWait)
+        c->maxWait = wait;
+      return true;
+    }
+
+    // next client
+    current = (current + 1) % numClient;
+    newTurn = true;
+  }
+  LIN_irqRestore(s);
+
+  return false;
+
+} // LIN_Arbiter::task()
+
+
+
+/**
+  \brief      Get client statistics
+  \details    Get client data incl. number of sent and rejected frames and queue wait time histogram.
+  \param[in]  Client      client ID
+  \return     client data, or NULL if client is invalid
+*/
+const LIN_arbiter_client_t *LIN_Arbiter::getClient(uint8_t Client)
+{
+  return (Client < numClient) ? &(client[Client]) : NULL;
+
+} // LIN_Arbiter::getClient()
+
+
+
+/**
+  \brief      Reset statistics
+  \details    Reset frame counters and wait time statistics of all clients. Queued frames are kept.
+*/
+void LIN_Arbiter::resetStats(void)
+{
+  for (uint8_t i=0; i<numClient; i++)
+  {
+    client[i].numSent     = 0;
+    client[i].numRejected = 0;
+    client[i].maxWait     = 0;
+    client[i].wait.reset();
+  }
+
+} // LIN_Arbiter::resetStats()
@@ -0,0 +1,100 @@
+/**
+  \file     LIN_arbiter.h
+  \brief    Weighted fair arbitration of ad-hoc frames from several clients
+  \details  This library queues ad-hoc frames of several clients (e.g. test modules sharing one LIN_Master) per client
+            and passes them to the background queue of a LIN_Schedule via deficit round robin, i.e. each client gets
+            a share of the idle bus time proportional to its weight. Queue wait time is tracked per client.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_ARBITER_H_
+#define _LIN_ARBITER_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_ARBITER_CLIENTS 4           //!< max. number of clients
+#define LIN_ARBITER_DEPTH   4           //!< depth of queue per client
+#define LIN_ARBITER_QUANTUM 11          //!< bytes per round and weight, >= longest frame (SYNC+ID+8 DATA+CHK)
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+#include "LIN_schedule.h"
+#include "LIN_histogram.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief client of arbiter
+*/
+typedef struct {
+    uint8_t               weight;                       //!< share of bus time, 0 = unused client
+    uint16_t              deficit;                      //!< remaining bytes in current round
+    LIN_schedule_entry_t  queue[LIN_ARBITER_DEPTH];     //!< queued frames
+    uint32_t              tSubmit[LIN_ARBITER_DEPTH];   //!< time of submit per queued frame [us]
+    uint8_t               head;                         //!< queue write index
+    uint8_t               num;                          //!< number of queued frames
+    uint16_t              numSent;                      //!< number of frames accepted by schedule
+    uint16_t              numRejected;                  //!< number of frames rejected due to full queue
+    uint32_t              maxWait;                      //!< max. queue wait time until passed to schedule [us]
+    LIN_Histogram         wait;                         //!< queue wait time until passed to schedule [us], saturated to 65ms
+} LIN_arbiter_client_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Weighted fair arbiter
+
+  \details Per-client queues for ad-hoc frames which are passed to LIN_Schedule::queueBackground() one at a time,
+           i.e. they are sent in idle slot time around the running schedule and never collide with it or each other.
+           Clients are served by deficit round robin with frame length as cost, so a client with weight 2 gets
+           twice the bus time of a client with weight 1, and a busy client can't starve the others.
+           Call task() frequently from the task scheduler, together with LIN_Schedule::idle().
+*/
+class LIN_Arbiter
+{
+  protected:
+
+    // internal variables
+    LIN_Schedule          *pSchedule;                                       //!< schedule for background frames
+    LIN_arbiter_client_t  client[LIN_ARBITER_CLIENTS];                      //!< clients
+    uint8_t               numClient;                                        //!< number of clients
+    uint8_t               current;                                          //!< client served in current round
+    bool                  newTurn;                                          //!< current client starts its turn
+
+  public:
+
+    // public methods
+    LIN_Arbiter(LIN_Schedule &Schedule);                                    //!< class constructor
+    int8_t                addClient(uint8_t Weight=1);                      //!< add client. Return client ID or -1
+    bool                  submit(uint8_t Client, const LIN_schedule_entry_t &Frame);  //!< queue frame of client
+    uint8_t               pending(uint8_t Client);                          //!< get number of queued frames of client
+    bool                  task(void);                                       //!< pass next frame to schedule. Return true if passed
+    const LIN_arbiter_client_t *getClient(uint8_t Client);                  //!< get client statistics
+    void                  resetStats(void);                                 //!< reset statistics of all clients
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_ARBITER_H_
@@ -0,0 +1,144 @@
+/**
+  \file     LIN_atomic.h
+  \brief    Minimal atomic primitives for LIN master emulation
+  \details  This file provides the atomic operations used by LIN_Master to share state between task scheduler
+            callbacks (interrupt context) and loop(). On ARMv7-M and later (e.g. Arduino Due) exclusive load/store
+            (LDREX/STREX) is used, i.e. interrupts are never masked. On other controllers (e.g. AVR) interrupts
+            are masked for a few instructions only, and the previous interrupt state is restored afterwards.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_ATOMIC_H_
+#define _LIN_ATOMIC_H_
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+// controllers with exclusive load/store instructions
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+  #define LIN_ATOMIC_LDREX                //!< use LDREX/STREX instead of masking interrupts
+#endif
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL FUNCTIONS
+-----------------------------------------------------------------------------*/
+
+/// compiler barrier. Sufficient for single core controllers
+#define LIN_ATOMIC_FENCE()   __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+
+// short masked sections which restore the previous interrupt state, i.e. are safe in interrupt context
+#if defined(__AVR__)
+
+  typedef uint8_t LIN_irq_t;          //!< saved interrupt state
+
+  /// mask interrupts and return previous state
+  static inline LIN_irq_t LIN_irqSave(void) { LIN_irq_t s = SREG; cli(); return s; }
+
+  /// restore previous interrupt state
+  static inline void LIN_irqRestore(LIN_irq_t s) { SREG = s; }
+
+#elif defined(__arm__)
+
+  typedef uint32_t LIN_irq_t;         //!< saved interrupt state
+
+  /// mask interrupts and return previous state
+  static inline LIN_irq_t LIN_irqSave(void) { LIN_irq_t s; __asm__ volatile ("mrs %0, primask\n\tcpsid i" : "=r" (s) : : "memory"); return s; }
+
+  /// restore previous interrupt state
+  static inline void LIN_irqRestore(LIN_irq_t s) { __asm__ volatile ("msr primask, %0" : : "r" (s) : "memory"); }
+
+#else
+
+  typedef uint8_t LIN_irq_t;          //!< saved interrupt state (unknown, interrupts are enabled on restore)
+
+  /// mask interrupts
+  static inline LIN_irq_t LIN_irqSave(void) { noInterrupts(); return 0; }
+
+  /// enable interrupts
+  static inline void LIN_irqRestore(LIN_irq_t s) { (void) s; interrupts(); }
+
+#endif
+
+
+/**
+  \brief     Atomic compare-and-swap
+  \details   Set Var to Desired if it equals Expected.
+  \param[in] Var        variable to modify
+  \param[in] Expected   expected value
+  \param[in] Desired    new value
+  \return    true if Var was modified
+*/
+template <class T> static inline bool LIN_atomicCAS(volatile T &Var, T Expected, T Desired)
+{
+  #if defined(LIN_ATOMIC_LDREX)
+    return __atomic_compare_exchange_n(&Var, &Expected, Desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+  #else
+    LIN_irq_t s = LIN_irqSave();
+    bool      ok = (Var == Expected);
+    if (ok)
+      Var = Desired;
+    LIN_irqRestore(s);
+    return ok;
+  #endif
+}
+
+
+/**
+  \brief     Atomic exchange
+  \details   Set Var to Value and return its previous value.
+  \param[in] Var        variable to modify
+  \param[in] Value      new value
+  \return    previous value of Var
+*/
+template <class T> static inline T LIN_atomicExchange(volatile T &Var, T Value)
+{
+  #if defined(LIN_ATOMIC_LDREX)
+    return __atomic_exchange_n(&Var, Value, __ATOMIC_ACQ_REL);
+  #else
+    LIN_irq_t s = LIN_irqSave();
+    T         old = Var;
+    Var = Value;
+    LIN_irqRestore(s);
+    return old;
+  #endif
+}
+
+
+/**
+  \brief     Atomic bitwise OR
+  \details   Set bits in Var, e.g. to latch error flags.
+  \param[in] Var        variable to modify
+  \param[in] Bits       bits to set
+*/
+template <class T> static inline void LIN_atomicOr(volatile T &Var, T Bits)
+{
+  #if defined(LIN_ATOMIC_LDREX)
+    __atomic_fetch_or(&Var, Bits, __ATOMIC_ACQ_REL);
+  #else
+    LIN_irq_t s = LIN_irqSave();
+    Var = (T) (Var | Bits);
+    LIN_irqRestore(s);
+  #endif
+}
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_ATOMIC_H_
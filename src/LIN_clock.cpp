@@ -0,0 +1,242 @@
+/**
+  \file     LIN_clock.cpp
+  \brief    Host/device clock correlation for LIN timestamps
+  \details  This library estimates offset and drift between micros() of the board and a host monotonic clock via a
+            round-trip exchange over a serial link. Device timestamps, e.g. of the execution trace, are then converted
+            to host time, so they can be merged with host-side logs over hours.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_clock.h"
+
+
+/**
+  \brief      Constructor for clock correlation
+  \details    Constructor for clock correlation. Not synchronized until the first host reply.
+  \param[in]  Link        serial link to host, e.g. Serial
+*/
+LIN_ClockSync::LIN_ClockSync(Stream &Link)
+{
+  pStream    = &Link;
+  lenLine    = 0;
+  devLast    = 0;
+  devAnchor  = 0;
+  hostAnchor = 0;
+  devRef     = 0;
+  hostRef    = 0;
+  drift      = 0;
+  rttMin     = 0xFFFFFFFF;
+  rttLast    = 0;
+  numSample  = 0;
+
+} // LIN_ClockSync::LIN_ClockSync()
+
+
+
+/**
+  \brief      Send sync request
+  \details    Send sync request "S<micros>\n" to host. Call periodically, e.g. every 10s.
+*/
+void LIN_ClockSync::request(void)
+{
+  uint32_t  t = micros();
+
+  devLast = extend(t);
+  pStream->print('S');
+  pStream->println(t);
+
+} // LIN_ClockSync::request()
+
+
+
+/**
+  \brief      Receive host reply
+  \details    Read available characters and evaluate a complete reply line. Lines not starting with 'T' are ignored.
+              Call frequently from loop().
+  \return     true if a new sample was accepted
+*/
+bool LIN_ClockSync::poll(void)
+{
+  bool  result = false;
+  int   c;
+
+  // keep 64 bit device time up to date
+  devLast = extend(micros());
+
+  // collect line, evaluate on newline
+  while ((c = pStream->read()) >= 0)
+  {
+    if ((c == '\n') || (c == '\r'))
+    {
+      line[lenLine] = '\0';
+      if ((lenLine > 0) && (line[0] == 'T'))
+        result |= parse();
+      lenLine = 0;
+    }
+    else if (lenLine < LIN_CLOCK_LINE-1)
+      line[lenLine++] = (char) c;
+  }
+
+  return result;
+
+} // LIN_ClockSync::poll()
+
+
+
+/**
+  \brief      Evaluate reply line
+  \details    Evaluate host reply "T<micros> <host time>" with reception time now.
+  \return     true if sample was accepted
+*/
+bool LIN_ClockSync::parse(void)
+{
+  uint32_t  tSend = 0, tReceive = micros();
+  uint64_t  host  = 0;
+  uint8_t   i     = 1;
+
+  // echoed device time
+  while ((line[i] >= '0') && (line[i] <= '9'))
+    tSend = 10 * tSend + (line[i++] - '0');
+  if (line[i++] != ' ')
+    return false;
+
+  // host time
+  if ((line[i] < '0') || (line[i] > '9'))
+    return false;
+  while ((line[i] >= '0') && (line[i] <= '9'))
+    host = 10 * host + (line[i++] - '0');
+
+  return addSample(tSend, host, tReceive);
+
+} // LIN_ClockSync::parse()
+
+
+
+/**
+  \brief      Add sample
+  \details    Add a round-trip sample, e.g. from a custom transport. The host time is assigned to the midpoint of the
+              round trip. Samples with long round-trip time are discarded.
+  \param[in]  tSend       micros() when request was sent
+  \param[in]  Host        host time when request was answered [us]
+  \param[in]  tReceive    micros() when reply was received
+  \return     true if sample was accepted
+*/
+bool LIN_ClockSync::addSample(uint32_t tSend, uint64_t Host, uint32_t tReceive)
+{
+  uint32_t  rtt = tReceive - tSend;
+  uint64_t  dev, span;
+  int32_t   driftNew;
+
+  // discard delayed replies
+  if (rtt < rttMin)
+    rttMin = rtt;
+  if (rtt > rttMin + LIN_CLOCK_MARGIN)
+    return false;
+  rttLast = rtt;
+
+  // device time at midpoint of round trip
+  dev = extend(tSend) + rtt/2;
+
+  // first sample -> anchor for drift estimation
+  if (numSample == 0)
+  {
+    devAnchor  = dev;
+    hostAnchor = Host;
+  }
+
+  // drift over baseline since first sample. Smooth to suppress latency jitter
+  span = dev - devAnchor;
+  if (span >= (uint64_t) LIN_CLOCK_SPAN)
+  {
+    driftNew = (int32_t) ((((int64_t) (Host - hostAnchor) - (int64_t) span) * 1000000000LL) / (int64_t) span);
+    if (drift == 0)
+      drift = driftNew;
+    else
+      drift += (driftNew - drift) / 4;
+  }
+
+  // last sample is reference for conversion
+  devRef  = dev;
+  hostRef = Host;
+  if (numSample < 255)
+    numSample++;
+
+  return true;
+
+} // LIN_ClockSync::addSample()
+
+
+
+/**
+  \brief      Extend device time to 64 bit
+  \details    Extend a micros() value to 64 bit. Must be within +/-35 minutes of the last poll().
+  \param[in]  Dev         micros() value
+  \return     extended device time [us]
+*/
+uint64_t LIN_ClockSync::extend(uint32_t Dev)
+{
+  return devLast + (int32_t) (Dev - (uint32_t) devLast);
+
+} // LIN_ClockSync::extend()
+
+
+
+/**
+  \brief      Convert device time to host time
+  \details    Convert a micros() value to host time via offset and drift of the last sample.
+  \param[in]  Dev         micros() value
+  \return     host time [us], or extended device time if not synchronized
+*/
+uint64_t LIN_ClockSync::toHost(uint32_t Dev)
+{
+  int64_t  delta;
+
+  if (numSample == 0)
+    return extend(Dev);
+  delta = (int64_t) (extend(Dev) - devRef);
+  return hostRef + delta + (delta * drift) / 1000000000LL;
+
+} // LIN_ClockSync::toHost()
+
+
+
+/**
+  \brief      Check if synchronized
+  \details    Check if at least one host reply was accepted.
+  \return     true if synchronized
+*/
+bool LIN_ClockSync::isSynced(void)
+{
+  return (numSample > 0);
+
+} // LIN_ClockSync::isSynced()
+
+
+
+/**
+  \brief      Get estimated drift
+  \details    Get estimated drift, i.e. host clock rate relative to device clock rate. 0 until LIN_CLOCK_SPAN has passed.
+  \return     drift [ppb], positive if device clock is slow
+*/
+int32_t LIN_ClockSync::getDrift(void)
+{
+  return drift;
+
+} // LIN_ClockSync::getDrift()
+
+
+
+/**
+  \brief      Get round-trip time
+  \details    Get round-trip time of last accepted sample, i.e. the max. offset error.
+  \return     round-trip time [us]
+*/
+uint32_t LIN_ClockSync::getRoundTrip(void)
+{
+  return rttLast;
+
+} // LIN_ClockSync::getRoundTrip()
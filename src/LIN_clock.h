@@ -0,0 +1,88 @@
+/**
+  \file     LIN_clock.h
+  \brief    Host/device clock correlation for LIN timestamps
+  \details  This library estimates offset and drift between micros() of the board and a host monotonic clock via a
+            round-trip exchange over a serial link. Device timestamps, e.g. of the execution trace, are then converted
+            to host time, so they can be merged with host-side logs over hours.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_CLOCK_H_
+#define _LIN_CLOCK_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_CLOCK_LINE      32          //!< max. length of host reply line
+#define LIN_CLOCK_MARGIN    2000        //!< accepted round-trip time above minimum [us]
+#define LIN_CLOCK_SPAN      10000000L   //!< min. time since first sample for drift estimation [us]
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Host/device clock correlation
+
+  \details Call request() periodically, e.g. every 10s, and poll() from loop(). request() sends "S<micros>\n", the host
+           replies "T<micros> <host time in us>\n" with the echoed device time. The host time is assigned to the
+           midpoint of the round trip, and samples with a round-trip time more than LIN_CLOCK_MARGIN above the
+           minimum are discarded, i.e. serial latency jitter is suppressed. Drift is estimated over the baseline
+           since the first sample, so its resolution improves with runtime.
+           micros() is extended to 64 bit, which requires a poll() at least every 35 minutes.
+*/
+class LIN_ClockSync
+{
+  protected:
+
+    // internal variables
+    Stream            *pStream;                                             //!< serial link to host
+    char              line[LIN_CLOCK_LINE];                                 //!< received reply line
+    uint8_t           lenLine;                                              //!< length of received line
+    uint64_t          devLast;                                              //!< last extended device time [us]
+    uint64_t          devAnchor;                                            //!< device time of first sample [us]
+    uint64_t          hostAnchor;                                           //!< host time of first sample [us]
+    uint64_t          devRef;                                               //!< device time of last sample [us]
+    uint64_t          hostRef;                                              //!< host time of last sample [us]
+    int32_t           drift;                                                //!< host clock rate - device clock rate [ppb]
+    uint32_t          rttMin;                                               //!< min. round-trip time [us]
+    uint32_t          rttLast;                                              //!< round-trip time of last sample [us]
+    uint8_t           numSample;                                            //!< number of accepted samples (saturated)
+
+    // internal methods
+    bool              parse(void);                                          //!< evaluate received reply line
+
+  public:
+
+    // public methods
+    LIN_ClockSync(Stream &Link);                                            //!< class constructor
+    void              request(void);                                        //!< send sync request to host
+    bool              poll(void);                                           //!< receive host reply. Return true on new sample
+    bool              addSample(uint32_t tSend, uint64_t Host, uint32_t tReceive);  //!< add sample from any transport
+    uint64_t          extend(uint32_t Dev);                                 //!< extend device time to 64 bit
+    uint64_t          toHost(uint32_t Dev);                                 //!< convert device time to host time [us]
+    bool              isSynced(void);                                       //!< check if a sample was received
+    int32_t           getDrift(void);                                       //!< get estimated drift [ppb]
+    uint32_t          getRoundTrip(void);                                   //!< get round-trip time of last sample [us]
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_CLOCK_H_
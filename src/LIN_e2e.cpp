@@ -0,0 +1,235 @@
+/**
+  \file     LIN_e2e.cpp
+  \brief    End-to-end protection of LIN frames
+  \details  This library inserts an alive counter and a CRC-8 into selected master requests and verifies both in
+            received slave responses. The CRC is calculated via a 256 byte table in flash, i.e. one lookup per byte.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_e2e.h"
+
+
+#if (LIN_E2E_POLY == 0x1D)
+
+/// CRC-8 table for SAE J1850 polynomial 0x1D
+static const uint8_t crcTable[256] PROGMEM = {
+  0x00, 0x1D, 0x3A, 0x27, 0x74, 0x69, 0x4E, 0x53, 0xE8, 0xF5, 0xD2, 0xCF, 0x9C, 0x81, 0xA6, 0xBB,
+  0xCD, 0xD0, 0xF7, 0xEA, 0xB9, 0xA4, 0x83, 0x9E, 0x25, 0x38, 0x1F, 0x02, 0x51, 0x4C, 0x6B, 0x76,
+  0x87, 0x9A, 0xBD, 0xA0, 0xF3, 0xEE, 0xC9, 0xD4, 0x6F, 0x72, 0x55, 0x48, 0x1B, 0x06, 0x21, 0x3C,
+  0x4A, 0x57, 0x70, 0x6D, 0x3E, 0x23, 0x04, 0x19, 0xA2, 0xBF, 0x98, 0x85, 0xD6, 0xCB, 0xEC, 0xF1,
+  0x13, 0x0E, 0x29, 0x34, 0x67, 0x7A, 0x5D, 0x40, 0xFB, 0xE6, 0xC1, 0xDC, 0x8F, 0x92, 0xB5, 0xA8,
+  0xDE, 0xC3, 0xE4, 0xF9, 0xAA, 0xB7, 0x90, 0x8D, 0x36, 0x2B, 0x0C, 0x11, 0x42, 0x5F, 0x78, 0x65,
+  0x94, 0x89, 0xAE, 0xB3, 0xE0, 0xFD, 0xDA, 0xC7, 0x7C, 0x61, 0x46, 0x5B, 0x08, 0x15, 0x32, 0x2F,
+  0x59, 0x44, 0x63, 0x7E, 0x2D, 0x30, 0x17, 0x0A, 0xB1, 0xAC, 0x8B, 0x96, 0xC5, 0xD8, 0xFF, 0xE2,
+  0x26, 0x3B, 0x1C, 0x01, 0x52, 0x4F, 0x68, 0x75, 0xCE, 0xD3, 0xF4, 0xE9, 0xBA, 0xA7, 0x80, 0x9D,
+  0xEB, 0xF6, 0xD1, 0xCC, 0x9F, 0x82, 0xA5, 0xB8, 0x03, 0x1E, 0x39, 0x24, 0x77, 0x6A, 0x4D, 0x50,
+  0xA1, 0xBC, 0x9B, 0x86, 0xD5, 0xC8, 0xEF, 0xF2, 0x49, 0x54, 0x73, 0x6E, 0x3D, 0x20, 0x07, 0x1A,
+  0x6C, 0x71, 0x56, 0x4B, 0x18, 0x05, 0x22, 0x3F, 0x84, 0x99, 0xBE, 0xA3, 0xF0, 0xED, 0xCA, 0xD7,
+  0x35, 0x28, 0x0F, 0x12, 0x41, 0x5C, 0x7B, 0x66, 0xDD, 0xC0, 0xE7, 0xFA, 0xA9, 0xB4, 0x93, 0x8E,
+  0xF8, 0xE5, 0xC2, 0xDF, 0x8C, 0x91, 0xB6, 0xAB, 0x10, 0x0D, 0x2A, 0x37, 0x64, 0x79, 0x5E, 0x43,
+  0xB2, 0xAF, 0x88, 0x95, 0xC6, 0xDB, 0xFC, 0xE1, 0x5A, 0x47, 0x60, 0x7D, 0x2E, 0x33, 0x14, 0x09,
+  0x7F, 0x62, 0x45, 0x58, 0x0B, 0x16, 0x31, 0x2C, 0x97, 0x8A, 0xAD, 0xB0, 0xE3, 0xFE, 0xD9, 0xC4
+};
+
+#endif // LIN_E2E_POLY
+
+
+/**
+  \brief      Constructor for E2E protection
+  \details    Constructor for E2E protection. Initially no frame ID is protected.
+*/
+LIN_E2E::LIN_E2E()
+{
+  for (uint8_t i=0; i<LIN_E2E_SIZE; i++)
+    entry[i].id = LIN_E2E_NONE;
+
+} // LIN_E2E::LIN_E2E()
+
+
+
+/**
+  \brief      Find entry of frame ID
+  \details    Find entry of frame ID via linear search, as only few frames are protected.
+  \param[in]  id          frame ID (protection optional)
+  \return     entry, or NULL if frame ID is not protected
+*/
+LIN_e2e_entry_t *LIN_E2E::find(uint8_t id)
+{
+  id &= 0x3F;
+  for (uint8_t i=0; i<LIN_E2E_SIZE; i++)
+  {
+    if (entry[i].id == id)
+      return &(entry[i]);
+  }
+  return NULL;
+
+} // LIN_E2E::find()
+
+
+
+/**
+  \brief      Protect frame ID
+  \details    Protect frame ID with counter and CRC. Counters are reset.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  DataId      data ID included in CRC
+  \return     false if LIN_E2E_SIZE frame IDs are already protected
+*/
+bool LIN_E2E::add(uint8_t id, uint8_t DataId)
+{
+  LIN_e2e_entry_t  *e = find(id);
+
+  // new frame ID -> use free entry
+  for (uint8_t i=0; (i<LIN_E2E_SIZE) && (e == NULL); i++)
+  {
+    if (entry[i].id == LIN_E2E_NONE)
+      e = &(entry[i]);
+  }
+  if (e == NULL)
+    return false;
+
+  // avoid inconsistent entry if LIN master uses it concurrently
+  LIN_irq_t s = LIN_irqSave();
+  e->id        = id & 0x3F;
+  e->dataId    = DataId;
+  e->counterTx = 14;
+  e->counterRx = LIN_E2E_NONE;
+  LIN_irqRestore(s);
+
+  return true;
+
+} // LIN_E2E::add()
+
+
+
+/**
+  \brief      Unprotect frame ID
+  \details    Remove counter and CRC handling of frame ID.
+  \param[in]  id          frame ID (protection optional)
+*/
+void LIN_E2E::remove(uint8_t id)
+{
+  LIN_e2e_entry_t  *e = find(id);
+
+  if (e != NULL)
+    e->id = LIN_E2E_NONE;
+
+} // LIN_E2E::remove()
+
+
+
+/**
+  \brief      Check if frame ID is protected
+  \details    Check if frame ID is protected.
+  \param[in]  id          frame ID (protection optional)
+  \return     true if protected
+*/
+bool LIN_E2E::contains(uint8_t id)
+{
+  return (find(id) != NULL);
+
+} // LIN_E2E::contains()
+
+
+
+/**
+  \brief      Calculate CRC of frame
+  \details    Calculate CRC-8 over data ID and data bytes 1..numData-1 with init 0xFF and final XOR 0xFF.
+              For the default polynomial one table lookup per byte is used.
+  \param[in]  DataId      data ID
+  \param[in]  numData     number of data bytes incl. CRC byte
+  \param[in]  data        data bytes. data[0] is the CRC and not included
+  \return     CRC
+*/
+uint8_t LIN_E2E::crc8(uint8_t DataId, uint8_t numData, const uint8_t *data)
+{
+  uint8_t  crc = 0xFF;
+
+  for (uint8_t i=0; i<numData; i++)
+  {
+    // data ID replaces CRC byte
+    crc ^= (i == 0) ? DataId : data[i];
+    #if (LIN_E2E_POLY == 0x1D)
+      crc = pgm_read_byte(&(crcTable[crc]));
+    #else
+      for (uint8_t j=0; j<8; j++)
+        crc = (crc & 0x80) ? (uint8_t) ((crc << 1) ^ LIN_E2E_POLY) : (uint8_t) (crc << 1);
+    #endif
+  }
+  return crc ^ 0xFF;
+
+} // LIN_E2E::crc8()
+
+
+
+/**
+  \brief      Insert counter and CRC
+  \details    Increment alive counter, insert it into data byte 1 and CRC into data byte 0.
+              Called by LIN_Master before the LIN checksum is calculated.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  numData     number of data bytes
+  \param[in,out] data     data bytes
+  \return     true if frame ID is protected and data was modified
+*/
+bool LIN_E2E::protect(uint8_t id, uint8_t numData, uint8_t *data)
+{
+  LIN_e2e_entry_t  *e = find(id);
+
+  // frame ID not protected or frame too short
+  if ((e == NULL) || (numData < 2))
+    return false;
+
+  // counter 0..14, then CRC
+  e->counterTx = (e->counterTx >= 14) ? 0 : e->counterTx + 1;
+  data[1] = (data[1] & 0xF0) | e->counterTx;
+  data[0] = crc8(e->dataId, numData, data);
+
+  return true;
+
+} // LIN_E2E::protect()
+
+
+
+/**
+  \brief      Verify counter and CRC
+  \details    Verify CRC and alive counter of a received frame. A repeated counter or a counter increment above
+              LIN_E2E_MAX_DELTA is an error. The counter is resynchronized to every frame with valid CRC.
+              Called by LIN_Master receive handler before dispatch.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  numData     number of data bytes
+  \param[in]  data        data bytes
+  \return     LIN_SUCCESS if frame ID is not protected or frame is valid, else LIN_ERROR_E2E
+*/
+LIN_error_t LIN_E2E::check(uint8_t id, uint8_t numData, uint8_t *data)
+{
+  LIN_e2e_entry_t  *e = find(id);
+  uint8_t          counter, delta, last;
+
+  // frame ID not protected
+  if (e == NULL)
+    return LIN_SUCCESS;
+
+  // frame too short
+  if (numData < 2)
+    return LIN_ERROR_E2E;
+
+  // wrong CRC or invalid counter
+  counter = data[1] & 0x0F;
+  if ((data[0] != crc8(e->dataId, numData, data)) || (counter > 14))
+    return LIN_ERROR_E2E;
+
+  // check counter increment. First frame is always accepted
+  last         = e->counterRx;
+  e->counterRx = counter;
+  if (last == LIN_E2E_NONE)
+    return LIN_SUCCESS;
+  delta = (counter + 15 - last) % 15;
+  if ((delta == 0) || (delta > LIN_E2E_MAX_DELTA))
+    return LIN_ERROR_E2E;
+
+  return LIN_SUCCESS;
+
+} // LIN_E2E::check()
@@ -0,0 +1,95 @@
+/**
+  \file     LIN_e2e.h
+  \brief    End-to-end protection of LIN frames
+  \details  This library inserts an alive counter and a CRC-8 into selected master requests and verifies both in
+            received slave responses. The CRC is calculated via a 256 byte table in flash, i.e. one lookup per byte.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_E2E_H_
+#define _LIN_E2E_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_E2E_SIZE        8           //!< max. number of protected frame IDs
+#define LIN_E2E_MAX_DELTA   2           //!< max. accepted counter increment, i.e. lost frames + 1
+#define LIN_E2E_NONE        0xFF        //!< ID of unused entry or counter before first reception
+
+// CRC polynomial. Default SAE J1850 uses a table in flash, other polynomials are calculated bitwise
+#ifndef LIN_E2E_POLY
+  #define LIN_E2E_POLY      0x1D        //!< CRC-8 polynomial (SAE J1850)
+#endif
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief entry of E2E protection
+*/
+typedef struct {
+    uint8_t           id;           //!< frame ID (unprotected), or LIN_E2E_NONE
+    uint8_t           dataId;       //!< data ID included in CRC, distinguishes frames with same layout
+    uint8_t           counterTx;    //!< last sent counter (master request)
+    uint8_t           counterRx;    //!< last received counter (slave response), or LIN_E2E_NONE
+} LIN_e2e_entry_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  End-to-end protection of LIN frames
+
+  \details Protection profile for frames with >=2 data bytes: byte 0 is the CRC-8 (init 0xFF, final XOR 0xFF) over
+           the data ID and data bytes 1..n-1, the low nibble of byte 1 is an alive counter 0..14.
+           Attach to a LIN_Master via LIN_Master::attachE2E(). Then protected master requests get counter and CRC
+           inserted before the LIN checksum, and protected slave responses with wrong CRC, repeated counter or
+           more than LIN_E2E_MAX_DELTA-1 lost frames are rejected with LIN_ERROR_E2E before dispatch.
+*/
+class LIN_E2E
+{
+  protected:
+
+    // internal variables
+    LIN_e2e_entry_t   entry[LIN_E2E_SIZE];                                  //!< protected frame IDs
+
+    // internal methods
+    LIN_e2e_entry_t   *find(uint8_t id);                                    //!< find entry of frame ID, or NULL
+
+  public:
+
+    // public methods
+    LIN_E2E();                                                              //!< class constructor
+    bool              add(uint8_t id, uint8_t DataId);                      //!< protect frame ID
+    void              remove(uint8_t id);                                   //!< unprotect frame ID
+    bool              contains(uint8_t id);                                 //!< check if frame ID is protected
+    bool              protect(uint8_t id, uint8_t numData, uint8_t *data);  //!< insert counter and CRC
+    LIN_error_t       check(uint8_t id, uint8_t numData, uint8_t *data);    //!< verify counter and CRC
+    static uint8_t    crc8(uint8_t DataId, uint8_t numData, const uint8_t *data);  //!< calculate CRC of frame
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_E2E_H_
@@ -0,0 +1,595 @@
+/**
+  \file     LIN_flasher.cpp
+  \brief    Parallel flashing of LIN slaves via diagnostic transport layer
+  \details  This library downloads an image to a LIN slave via UDS services RequestDownload, TransferData and
+            RequestTransferExit, segmented by the LIN transport layer into diagnostic frames of a LIN_Schedule.
+            A LIN_Flasher_Group flashes slaves on several buses concurrently from one image source. Identical slaves
+            on one bus are flashed at once via the broadcast NAD and then verified individually.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_flasher.h"
+
+
+/**
+  \brief      Update CRC-16/CCITT
+  \details    Update CRC-16/CCITT (polynom 0x1021) bitwise, i.e. w/o table in flash.
+  \param[in]  crc         CRC so far, 0xFFFF for start
+  \param[in]  data        data bytes
+  \param[in]  len         number of data bytes
+  \return     updated CRC
+*/
+static uint16_t crc16(uint16_t crc, const uint8_t *data, uint8_t len)
+{
+  while (len--)
+  {
+    crc ^= (uint16_t) (*data++) << 8;
+    for (uint8_t i=0; i<8; i++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+  return crc;
+
+} // crc16()
+
+
+
+/**
+  \brief      Constructor for flasher
+  \details    Constructor for flasher of one slave. Download is not started.
+  \param[in]  Schedule    schedule of LIN master the slave is connected to
+  \param[in]  NAD         node address of slave
+*/
+LIN_Flasher::LIN_Flasher(LIN_Schedule &Schedule, uint8_t NAD)
+{
+  pSchedule    = &Schedule;
+  nad          = NAD;
+  nadTx        = NAD;
+  nadList      = NULL;
+  numNad       = 0;
+  idxVerify    = 0;
+  verified     = 0;
+  delayBroadcast = LIN_FLASH_DELAY;
+  crc          = 0xFFFF;
+  readImage    = NULL;
+  imageContext = NULL;
+  address      = 0;
+  size         = 0;
+  offset       = 0;
+  state        = LIN_FLASH_IDLE;
+  lenMsg       = 0;
+  posMsg       = 0;
+  flagResp     = false;
+  nrc          = 0;
+
+} // LIN_Flasher::LIN_Flasher()
+
+
+
+/**
+  \brief      Flash identical slaves via broadcast NAD
+  \details    Send the image once to the broadcast NAD instead of the NAD passed to the constructor, then verify
+              each NAD individually. Must be called before start().
+  \param[in]  NADs        NADs of identical slaves. Must remain valid during download. NULL to disable broadcast
+  \param[in]  Num         number of NADs (max. LIN_FLASH_NADS)
+  \param[in]  Delay       programming time per request, as slaves don't respond to broadcast [ms]
+*/
+void LIN_Flasher::setBroadcast(const uint8_t *NADs, uint8_t Num, uint16_t Delay)
+{
+  nadList        = NADs;
+  numNad         = (NADs == NULL) ? 0 : ((Num > LIN_FLASH_NADS) ? LIN_FLASH_NADS : Num);
+  delayBroadcast = Delay;
+
+} // LIN_Flasher::setBroadcast()
+
+
+
+/**
+  \brief      Start download
+  \details    Start download of an image with RequestDownload. Image is read block by block from Read.
+  \param[in]  Read        image source
+  \param[in]  Context     context pointer passed to image source
+  \param[in]  Size        size of image [B]
+  \param[in]  Address     target address of image in slave
+*/
+void LIN_Flasher::start(LIN_image_read_t Read, void *Context, uint32_t Size, uint32_t Address)
+{
+  // store image
+  readImage    = Read;
+  imageContext = Context;
+  size         = Size;
+  address      = Address;
+  offset       = 0;
+  nrc          = 0;
+  verified     = 0;
+  crc          = 0xFFFF;
+  nadTx        = (numNad > 0) ? LIN_FLASH_BROADCAST : nad;
+
+  // RequestDownload: no compression/encryption, 4 byte address and size
+  msg[0]  = 0x34;
+  msg[1]  = 0x00;
+  msg[2]  = 0x44;
+  msg[3]  = (uint8_t) (Address >> 24);
+  msg[4]  = (uint8_t) (Address >> 16);
+  msg[5]  = (uint8_t) (Address >> 8);
+  msg[6]  = (uint8_t) Address;
+  msg[7]  = (uint8_t) (Size >> 24);
+  msg[8]  = (uint8_t) (Size >> 16);
+  msg[9]  = (uint8_t) (Size >> 8);
+  msg[10] = (uint8_t) Size;
+  startRequest(11);
+
+} // LIN_Flasher::start()
+
+
+
+/**
+  \brief      Run download
+  \details    Non-blocking download step. Queues the next request frame or response poll if the diagnostic
+              channel is free and evaluates received responses. Call from loop() until false is returned.
+              A request frame dropped by the schedule after LIN_SCHEDULE_RETRY repetitions aborts the download.
+  \return     true while download is ongoing
+*/
+bool LIN_Flasher::task(void)
+{
+  switch (state)
+  {
+    // queue request frames one by one, then poll response
+    case LIN_FLASH_SEND:
+      if (pSchedule->diagnosticPending())
+        break;
+
+      // request frame dropped after max. retries -> abort. Verification continues with next NAD
+      if ((posMsg > 0) && (pSchedule->diagnosticFailed()))
+      {
+        nrc = 0;
+        if (msg[0] == 0x31)
+          endVerify(false);
+        else
+          state = LIN_FLASH_ERROR;
+      }
+      else if (posMsg < lenMsg)
+        sendFrame();
+
+      // broadcast w/o response -> wait programming time. Last frame has finished on the bus, see above
+      else if (nadTx == LIN_FLASH_BROADCAST)
+      {
+        tResponse = millis();
+        state     = LIN_FLASH_WAIT;
+      }
+      else if (pSchedule->queueDiagnosticResponse(onResponse, this) == LIN_SUCCESS)
+      {
+        tResponse = millis();
+        state     = LIN_FLASH_WAIT;
+      }
+      break;
+
+    // evaluate response
+    case LIN_FLASH_WAIT:
+
+      // broadcast -> continue after programming time. It starts when the last frame was sent successfully
+      if (nadTx == LIN_FLASH_BROADCAST)
+      {
+        if (pSchedule->diagnosticPending())
+          tResponse = millis();
+        else if (millis() - tResponse >= delayBroadcast)
+          nextRequest();
+      }
+
+      else if (flagResp)
+      {
+        flagResp = false;
+
+        // ignore responses of other nodes and segmented responses
+        if ((resp[0] != nadTx) || ((resp[1] & 0xF0) != 0x00))
+          break;
+
+        // verification of a NAD -> checkMemory result 0x00 is correct
+        if ((msg[0] == 0x31) && (resp[2] == 0x71))
+          endVerify(resp[6] == 0x00);
+
+        // positive response -> continue with next request
+        else if (resp[2] == msg[0] + 0x40)
+          nextRequest();
+
+        // response pending -> restart timeout
+        else if ((resp[2] == 0x7F) && (resp[4] == 0x78))
+          tResponse = millis();
+
+        // negative response -> abort. Verification continues with next NAD
+        else if (resp[2] == 0x7F)
+        {
+          nrc = resp[4];
+          if (msg[0] == 0x31)
+            endVerify(false);
+          else
+            state = LIN_FLASH_ERROR;
+        }
+      }
+
+      // no response yet -> abort after timeout, else poll again
+      else if (!pSchedule->diagnosticPending())
+      {
+        if ((millis() - tResponse > LIN_FLASH_P2MAX) && (msg[0] == 0x31))
+          endVerify(false);
+        else if (millis() - tResponse > LIN_FLASH_P2MAX)
+          state = LIN_FLASH_ERROR;
+        else
+          pSchedule->queueDiagnosticResponse(onResponse, this);
+      }
+      break;
+
+    // not started, finished or failed
+    default:
+      return false;
+
+  } // switch (state)
+
+  return true;
+
+} // LIN_Flasher::task()
+
+
+
+/**
+  \brief      Get state of flasher
+  \details    Get state of flasher.
+  \return     state of flasher
+*/
+LIN_flash_state_t LIN_Flasher::getState(void)
+{
+  return state;
+
+} // LIN_Flasher::getState()
+
+
+
+/**
+  \brief      Get progress of download
+  \details    Get number of image bytes acknowledged by slave.
+  \return     acknowledged image bytes
+*/
+uint32_t LIN_Flasher::getProgress(void)
+{
+  return offset;
+
+} // LIN_Flasher::getProgress()
+
+
+
+/**
+  \brief      Get verified NADs
+  \details    Get result of per-NAD verification after broadcast download.
+  \return     bitmask of verified NADs, bit i for i-th NAD passed to setBroadcast()
+*/
+uint16_t LIN_Flasher::getVerified(void)
+{
+  return verified;
+
+} // LIN_Flasher::getVerified()
+
+
+
+/**
+  \brief      Get negative response code
+  \details    Get negative response code of failed download.
+  \return     negative response code, or 0 on timeout, dropped frame, image read error or no error
+*/
+uint8_t LIN_Flasher::getNRC(void)
+{
+  return nrc;
+
+} // LIN_Flasher::getNRC()
+
+
+
+/**
+  \brief      Store slave response
+  \details    Store diagnostic slave response. Called by LIN master receive handler, i.e. possibly in background.
+  \param[in]  Context     flasher instance
+  \param[in]  numData     number of received data bytes
+  \param[in]  data        received data bytes
+*/
+void LIN_Flasher::onResponse(void *Context, uint8_t numData, uint8_t *data)
+{
+  LIN_Flasher  *self = (LIN_Flasher*) Context;
+
+  memcpy(self->resp, data, (numData < 8) ? numData : 8);
+  self->flagResp = true;
+
+} // LIN_Flasher::onResponse()
+
+
+
+/**
+  \brief      Start UDS request
+  \details    Start sending the UDS request stored in msg.
+  \param[in]  Len         length of request [B]
+*/
+void LIN_Flasher::startRequest(uint16_t Len)
+{
+  lenMsg   = Len;
+  posMsg   = 0;
+  flagResp = false;
+  state    = LIN_FLASH_SEND;
+
+} // LIN_Flasher::startRequest()
+
+
+
+/**
+  \brief      Start request following a positive response
+  \details    After RequestDownload or TransferData send next image block, after the last block RequestTransferExit.
+*/
+void LIN_Flasher::nextRequest(void)
+{
+  // transfer exit acknowledged -> finished, or verify NADs after broadcast
+  if (msg[0] == 0x37)
+  {
+    if (numNad > 0)
+    {
+      idxVerify = 0;
+      startVerify();
+    }
+    else
+      state = LIN_FLASH_DONE;
+    return;
+  }
+
+  // block acknowledged -> advance
+  if (msg[0] == 0x36)
+  {
+    offset += lenBlock;
+    blockSeq++;
+  }
+  else
+    blockSeq = 1;
+
+  // all blocks transferred -> RequestTransferExit
+  if (offset >= size)
+  {
+    msg[0] = 0x37;
+    startRequest(1);
+    return;
+  }
+
+  // TransferData with next image block
+  lenBlock = ((size - offset) < LIN_FLASH_BLOCK) ? (uint8_t) (size - offset) : LIN_FLASH_BLOCK;
+  msg[0]   = 0x36;
+  msg[1]   = blockSeq;
+  if (readImage(imageContext, offset, msg+2, lenBlock) != lenBlock)
+  {
+    state = LIN_FLASH_ERROR;
+    return;
+  }
+  crc = crc16(crc, msg+2, lenBlock);
+  startRequest(lenBlock + 2);
+
+} // LIN_Flasher::nextRequest()
+
+
+
+/**
+  \brief      Start verification of next NAD
+  \details    Send RoutineControl checkMemory with CRC of the transferred image to the next NAD of the broadcast list.
+*/
+void LIN_Flasher::startVerify(void)
+{
+  nadTx  = nadList[idxVerify];
+  msg[0] = 0x31;                    // RoutineControl
+  msg[1] = 0x01;                    // startRoutine
+  msg[2] = 0x02;                    // checkMemory
+  msg[3] = 0x02;
+  msg[4] = (uint8_t) (crc >> 8);
+  msg[5] = (uint8_t) crc;
+  startRequest(6);
+
+} // LIN_Flasher::startVerify()
+
+
+
+/**
+  \brief      Store verification result of NAD
+  \details    Store verification result of current NAD and continue with next NAD. After last NAD the download is
+              finished, or failed if any NAD was not verified.
+  \param[in]  Ok          true if NAD reported correct memory
+*/
+void LIN_Flasher::endVerify(bool Ok)
+{
+  if (Ok)
+    verified |= (uint16_t) (1U << idxVerify);
+
+  // next NAD
+  if (++idxVerify < numNad)
+  {
+    startVerify();
+    return;
+  }
+
+  // all NADs verified?
+  state = (verified == (uint16_t) ((1UL << numNad) - 1)) ? LIN_FLASH_DONE : LIN_FLASH_ERROR;
+
+} // LIN_Flasher::endVerify()
+
+
+
+/**
+  \brief      Queue next request frame
+  \details    Queue next single, first or consecutive frame of the current request as diagnostic master request.
+              If the diagnostic channel is busy, the frame is queued in the next call.
+*/
+void LIN_Flasher::sendFrame(void)
+{
+  uint8_t  frame[8], num;
+
+  // unused bytes are padded with 0xFF
+  memset(frame, 0xFF, 8);
+  frame[0] = nadTx;
+
+  // single frame
+  if (lenMsg <= 6)
+  {
+    frame[1] = lenMsg;
+    num = lenMsg;
+    memcpy(frame+2, msg, num);
+  }
+
+  // first frame with 12 bit length
+  else if (posMsg == 0)
+  {
+    frame[1] = 0x10 | (uint8_t) (lenMsg >> 8);
+    frame[2] = (uint8_t) lenMsg;
+    num = 5;
+    memcpy(frame+3, msg, num);
+  }
+
+  // consecutive frame
+  else
+  {
+    frame[1] = 0x20 | (sn & 0x0F);
+    num = ((lenMsg - posMsg) < 6) ? (uint8_t) (lenMsg - posMsg) : 6;
+    memcpy(frame+2, msg+posMsg, num);
+  }
+
+  // advance only if frame was queued
+  if (pSchedule->queueDiagnostic(frame, NULL, NULL) != LIN_SUCCESS)
+    return;
+  sn = (posMsg == 0) ? 1 : sn + 1;
+  posMsg += num;
+
+} // LIN_Flasher::sendFrame()
+
+
+
+/**
+  \brief      Constructor for flasher group
+  \details    Constructor for flasher group. Group is empty.
+*/
+LIN_Flasher_Group::LIN_Flasher_Group()
+{
+  numFlasher = 0;
+  size       = 0;
+
+} // LIN_Flasher_Group::LIN_Flasher_Group()
+
+
+
+/**
+  \brief      Add flasher to group
+  \details    Add flasher to group. Flashers should use different buses, else they are serialized by the schedule.
+  \param[in]  Flasher     flasher to add
+  \return     false if group is full
+*/
+bool LIN_Flasher_Group::add(LIN_Flasher &Flasher)
+{
+  if (numFlasher >= LIN_FLASH_BUSES)
+    return false;
+  flasher[numFlasher++] = &Flasher;
+  return true;
+
+} // LIN_Flasher_Group::add()
+
+
+
+/**
+  \brief      Start download on all buses
+  \details    Start download of the same image on all flashers of the group.
+  \param[in]  Read        image source. Is called by each flasher with its own offset
+  \param[in]  Context     context pointer passed to image source
+  \param[in]  Size        size of image [B]
+  \param[in]  Address     target address of image in slaves
+*/
+void LIN_Flasher_Group::start(LIN_image_read_t Read, void *Context, uint32_t Size, uint32_t Address)
+{
+  size = Size;
+  for (uint8_t i=0; i<numFlasher; i++)
+    flasher[i]->start(Read, Context, Size, Address);
+
+} // LIN_Flasher_Group::start()
+
+
+
+/**
+  \brief      Run all downloads
+  \details    Run one step of each flasher. Call from loop() until false is returned.
+  \return     true while any download is ongoing
+*/
+bool LIN_Flasher_Group::task(void)
+{
+  bool  busy = false;
+
+  for (uint8_t i=0; i<numFlasher; i++)
+    busy |= flasher[i]->task();
+  return busy;
+
+} // LIN_Flasher_Group::task()
+
+
+
+/**
+  \brief      Get overall progress
+  \details    Get acknowledged image bytes of all flashers relative to total image bytes.
+  \return     overall progress [%]
+*/
+uint8_t LIN_Flasher_Group::getProgress(void)
+{
+  uint32_t  done = 0;
+
+  if ((numFlasher == 0) || (size == 0))
+    return 0;
+  for (uint8_t i=0; i<numFlasher; i++)
+    done += flasher[i]->getProgress() / numFlasher;
+  return (uint8_t) ((done * 100) / size);
+
+} // LIN_Flasher_Group::getProgress()
+
+
+
+/**
+  \brief      Get number of successful downloads
+  \details    Get number of flashers in state LIN_FLASH_DONE.
+  \return     number of successful downloads
+*/
+uint8_t LIN_Flasher_Group::numDone(void)
+{
+  uint8_t  num = 0;
+
+  for (uint8_t i=0; i<numFlasher; i++)
+    num += (flasher[i]->getState() == LIN_FLASH_DONE);
+  return num;
+
+} // LIN_Flasher_Group::numDone()
+
+
+
+/**
+  \brief      Get number of failed downloads
+  \details    Get number of flashers in state LIN_FLASH_ERROR. See LIN_Flasher::getNRC() for cause.
+  \return     number of failed downloads
+*/
+uint8_t LIN_Flasher_Group::numFailed(void)
+{
+  uint8_t  num = 0;
+
+  for (uint8_t i=0; i<numFlasher; i++)
+    num += (flasher[i]->getState() == LIN_FLASH_ERROR);
+  return num;
+
+} // LIN_Flasher_Group::numFailed()
+
+
+
+/**
+  \brief      Get flasher
+  \details    Get flasher of group, e.g. to query its state and error.
+  \param[in]  idx         index in order of add()
+  \return     flasher, or NULL if index is invalid
+*/
+LIN_Flasher *LIN_Flasher_Group::get(uint8_t idx)
+{
+  return (idx < numFlasher) ? flasher[idx] : NULL;
+
+} // LIN_Flasher_Group::get()
@@ -0,0 +1,166 @@
+/**
+  \file     LIN_flasher.h
+  \brief    Parallel flashing of LIN slaves via diagnostic transport layer
+  \details  This library downloads an image to a LIN slave via UDS services RequestDownload, TransferData and
+            RequestTransferExit, segmented by the LIN transport layer into diagnostic frames of a LIN_Schedule.
+            A LIN_Flasher_Group flashes slaves on several buses concurrently from one image source. Identical slaves
+            on one bus are flashed at once via the broadcast NAD and then verified individually.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_FLASHER_H_
+#define _LIN_FLASHER_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_FLASH_BLOCK     64          //!< image bytes per TransferData request
+#define LIN_FLASH_P2MAX     1000        //!< max. time until response, restarted by "response pending" [ms]
+#define LIN_FLASH_BUSES     4           //!< max. number of flashers in a group
+#define LIN_FLASH_NADS      16          //!< max. number of slaves flashed via broadcast NAD
+#define LIN_FLASH_BROADCAST 0x7F        //!< broadcast NAD
+#define LIN_FLASH_DELAY     50          //!< default programming time per broadcast request w/o response [ms]
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+#include "LIN_schedule.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief state of flasher
+*/
+typedef enum {
+    LIN_FLASH_IDLE      = 0,        //!< not started
+    LIN_FLASH_SEND      = 1,        //!< sending request frames
+    LIN_FLASH_WAIT      = 2,        //!< polling response
+    LIN_FLASH_DONE      = 3,        //!< image downloaded
+    LIN_FLASH_ERROR     = 4         //!< negative response, timeout, dropped frame or image read error
+} LIN_flash_state_t;
+
+
+/**
+    \brief image source. Copy Len bytes from Offset to Buf and return number of copied bytes
+*/
+typedef uint8_t (*LIN_image_read_t)(void*,uint32_t,uint8_t*,uint8_t);
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Flasher for one LIN slave
+
+  \details Download an image to one slave via the diagnostic channel of a LIN_Schedule, i.e. application frames
+           keep running during flashing depending on LIN_Schedule::setDiagnosticRatio(). Requests are segmented
+           into single, first and consecutive frames (one per diagnostic slot), responses are polled until a
+           positive or negative single-frame response is received. Call task() from loop() until it returns false.
+           After setBroadcast() the image is sent once to the broadcast NAD. As slaves don't respond to broadcast
+           requests, a fixed programming time is waited instead. Then each NAD is verified via RoutineControl
+           checkMemory (0x0202) with the CRC-16/CCITT of the image.
+*/
+class LIN_Flasher
+{
+  protected:
+
+    // internal variables
+    LIN_Schedule      *pSchedule;                                           //!< schedule for diagnostic frames
+    uint8_t           nad;                                                  //!< NAD of slave
+    uint8_t           nadTx;                                                //!< NAD of current request
+    const uint8_t     *nadList;                                             //!< NADs flashed via broadcast, or NULL
+    uint8_t           numNad;                                               //!< number of NADs flashed via broadcast
+    uint8_t           idxVerify;                                            //!< index of NAD being verified
+    uint16_t          verified;                                             //!< bitmask of verified NADs
+    uint16_t          delayBroadcast;                                       //!< programming time per broadcast request [ms]
+    uint16_t          crc;                                                  //!< CRC-16/CCITT of transferred image
+    LIN_image_read_t  readImage;                                            //!< image source
+    void              *imageContext;                                        //!< context pointer passed to image source
+    uint32_t          address;                                              //!< target address of image in slave
+    uint32_t          size;                                                 //!< size of image [B]
+    uint32_t          offset;                                               //!< image bytes acknowledged by slave [B]
+    LIN_flash_state_t state;                                                //!< state of flasher
+    uint8_t           msg[LIN_FLASH_BLOCK+2];                               //!< current UDS request
+    uint16_t          lenMsg;                                               //!< length of current request
+    uint16_t          posMsg;                                               //!< request bytes already queued
+    uint8_t           sn;                                                   //!< sequence number of next consecutive frame
+    uint8_t           blockSeq;                                             //!< TransferData block sequence counter
+    uint8_t           lenBlock;                                             //!< image bytes in current TransferData
+    uint8_t           resp[8];                                              //!< received slave response
+    volatile bool     flagResp;                                             //!< slave response received
+    uint32_t          tResponse;                                            //!< start of response timeout [ms]
+    uint8_t           nrc;                                                  //!< negative response code, or 0
+
+    // internal methods
+    static void       onResponse(void *Context, uint8_t numData, uint8_t *data);  //!< store slave response
+    void              startRequest(uint16_t Len);                           //!< start sending UDS request in msg
+    void              nextRequest(void);                                    //!< start request following a positive response
+    void              sendFrame(void);                                      //!< queue next request frame
+    void              startVerify(void);                                    //!< start verification of next NAD
+    void              endVerify(bool Ok);                                   //!< store verification result of NAD
+
+  public:
+
+    // public methods
+    LIN_Flasher(LIN_Schedule &Schedule, uint8_t NAD);                      //!< class constructor
+    void              setBroadcast(const uint8_t *NADs, uint8_t Num, uint16_t Delay=LIN_FLASH_DELAY);  //!< flash identical slaves via broadcast NAD
+    void              start(LIN_image_read_t Read, void *Context, uint32_t Size, uint32_t Address);  //!< start download
+    bool              task(void);                                           //!< run download. Return true while busy
+    uint16_t          getVerified(void);                                    //!< get bitmask of verified NADs in broadcast mode
+    LIN_flash_state_t getState(void);                                       //!< get state of flasher
+    uint32_t          getProgress(void);                                    //!< get acknowledged image bytes
+    uint8_t           getNRC(void);                                         //!< get negative response code, or 0 on timeout
+};
+
+
+
+/**
+  \brief  Group of flashers on several buses
+
+  \details Flash slaves on up to LIN_FLASH_BUSES buses concurrently from one image source. Each flasher keeps its
+           own flow control, i.e. a slow or failing slave does not delay the others. Progress and errors are
+           aggregated, e.g. `group.start(...); while (group.task()) { ... }`.
+*/
+class LIN_Flasher_Group
+{
+  protected:
+
+    // internal variables
+    LIN_Flasher       *flasher[LIN_FLASH_BUSES];                            //!< flashers in group
+    uint8_t           numFlasher;                                           //!< number of flashers in group
+    uint32_t          size;                                                 //!< size of image [B]
+
+  public:
+
+    // public methods
+    LIN_Flasher_Group();                                                    //!< class constructor
+    bool              add(LIN_Flasher &Flasher);                            //!< add flasher to group
+    void              start(LIN_image_read_t Read, void *Context, uint32_t Size, uint32_t Address);  //!< start download on all buses
+    bool              task(void);                                           //!< run all downloads. Return true while any is busy
+    uint8_t           getProgress(void);                                    //!< get overall progress [%]
+    uint8_t           numDone(void);                                        //!< get number of successful downloads
+    uint8_t           numFailed(void);                                      //!< get number of failed downloads
+    LIN_Flasher       *get(uint8_t idx);                                    //!< get flasher, e.g. for its error
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_FLASHER_H_
@@ -0,0 +1,147 @@
+/**
+  \file     LIN_frame.cpp
+  \brief    Signal store for LIN master request frames
+  \details  This library provides a per-frame signal store for master requests. The application writes
+            signals at any time, and LIN_Master::sendMasterRequest(LIN_Frame&) assembles the frame only
+            at slot time and only for changed bytes. The checksum is updated incrementally per changed byte.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_frame.h"
+
+
+/**
+  \brief      Constructor for frame signal store
+  \details    Constructor for frame signal store. All data bytes are initialized with 0.
+  \param[in]  Id          frame ID (protection optional)
+  \param[in]  NumData     number of data bytes (0..8)
+*/
+LIN_Frame::LIN_Frame(uint8_t Id, uint8_t NumData)
+{
+  // store frame parameters
+  id      = Id;
+  numData = (NumData > 8) ? 8 : NumData;
+
+  // empty store and frame. Header and checksum are set at first assembly
+  memset(data, 0, 8);
+  memset(buf, 0, 12);
+  dirty      = 0x00;
+  sum        = 0;
+  versionChk = 0;
+
+} // LIN_Frame::LIN_Frame()
+
+
+
+/**
+  \brief      Write data byte
+  \details    Write data byte into signal store. Byte is only marked dirty if its value changes.
+  \param[in]  idx         byte index (0..numData-1)
+  \param[in]  value       new value
+*/
+void LIN_Frame::setByte(uint8_t idx, uint8_t value)
+{
+  // index out of range or value unchanged
+  if ((idx >= numData) || (data[idx] == value))
+    return;
+
+  // store value and mark dirty
+  data[idx] = value;
+  LIN_atomicOr(dirty, (uint8_t) (1 << idx));
+
+} // LIN_Frame::setByte()
+
+
+
+/**
+  \brief      Read data byte
+  \details    Read data byte from signal store.
+  \param[in]  idx         byte index (0..numData-1)
+  \return     byte value, or 0 if out of range
+*/
+uint8_t LIN_Frame::getByte(uint8_t idx)
+{
+  return (idx < numData) ? data[idx] : 0;
+
+} // LIN_Frame::getByte()
+
+
+
+/**
+  \brief      Write signal
+  \details    Write a signal of up to 32 bits into signal store. Only affected bytes are marked dirty. Bits beyond
+              the frame length are ignored.
+  \param[in]  startBit    position of signal LSB in frame (0..63)
+  \param[in]  length      signal length in bits (1..32)
+  \param[in]  value       signal value
+*/
+void LIN_Frame::setSignal(uint8_t startBit, uint8_t length, uint32_t value)
+{
+  uint8_t  idx, shift, num, mask;
+
+  // loop over affected bytes
+  while (length > 0)
+  {
+    idx   = startBit >> 3;
+    if (idx >= numData)
+      return;
+    shift = startBit & 0x07;
+    num   = ((8 - shift) < length) ? (8 - shift) : length;
+    mask  = (uint8_t) (((1 << num) - 1) << shift);
+
+    setByte(idx, (uint8_t) ((data[idx] & ~mask) | (((uint8_t) value << shift) & mask)));
+
+    value    >>= num;
+    startBit  += num;
+    length    -= num;
+  }
+
+} // LIN_Frame::setSignal()
+
+
+
+/**
+  \brief      Read signal
+  \details    Read a signal of up to 32 bits from signal store.
+  \param[in]  startBit    position of signal LSB in frame (0..63)
+  \param[in]  length      signal length in bits (1..32)
+  \return     signal value
+*/
+uint32_t LIN_Frame::getSignal(uint8_t startBit, uint8_t length)
+{
+  uint32_t  value = 0;
+  uint8_t   pos = 0, shift, num;
+
+  // loop over affected bytes
+  while (length > 0)
+  {
+    shift = startBit & 0x07;
+    num   = ((8 - shift) < length) ? (8 - shift) : length;
+
+    value |= (uint32_t) ((getByte(startBit >> 3) >> shift) & ((1 << num) - 1)) << pos;
+
+    pos      += num;
+    startBit += num;
+    length   -= num;
+  }
+
+  return value;
+
+} // LIN_Frame::getSignal()
+
+
+
+/**
+  \brief      Check if data changed
+  \details    Check if data changed since the frame was last sent.
+  \return     true if at least one data byte is dirty
+*/
+bool LIN_Frame::isDirty(void)
+{
+  return (dirty != 0x00);
+
+} // LIN_Frame::isDirty()
@@ -0,0 +1,68 @@
+/**
+  \file     LIN_frame.h
+  \brief    Signal store for LIN master request frames
+  \details  This library provides a per-frame signal store for master requests. The application writes
+            signals at any time, and LIN_Master::sendMasterRequest(LIN_Frame&) assembles the frame only
+            at slot time and only for changed bytes. The checksum is updated incrementally per changed byte.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_FRAME_H_
+#define _LIN_FRAME_H_
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Signal store of a master request frame
+
+  \details Signal store of a master request frame. Changed data bytes are marked dirty and copied to the
+           assembled frame by LIN_Master::sendMasterRequest(LIN_Frame&). Signals are little-endian with bit 0
+           being the LSB of data byte 0, as in LIN description files.
+*/
+class LIN_Frame
+{
+  friend class LIN_Master;
+
+  protected:
+
+    // internal variables
+    uint8_t           id;                                                   //!< frame ID (protection optional)
+    uint8_t           numData;                                              //!< number of data bytes (0..8)
+    uint8_t           data[8];                                              //!< signal store, written by application
+    volatile uint8_t  dirty;                                                //!< bitmask of data bytes changed since last assembly
+    uint8_t           buf[12];                                              //!< assembled frame incl. BREAK, SYNC, ID, DATA and CHK
+    uint16_t          sum;                                                  //!< raw sum of data bytes in buf (w/o carry)
+    uint8_t           versionChk;                                           //!< LIN version of checksum in buf. 0 = not yet assembled
+
+  public:
+
+    // public methods
+    LIN_Frame(uint8_t Id, uint8_t NumData);                                 //!< class constructor
+    void              setByte(uint8_t idx, uint8_t value);                  //!< write data byte
+    uint8_t           getByte(uint8_t idx);                                 //!< read data byte
+    void              setSignal(uint8_t startBit, uint8_t length, uint32_t value);  //!< write signal
+    uint32_t          getSignal(uint8_t startBit, uint8_t length);          //!< read signal
+    bool              isDirty(void);                                        //!< check if data changed since last frame
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_FRAME_H_
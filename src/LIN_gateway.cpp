@@ -0,0 +1,326 @@
+/**
+  \file     LIN_gateway.cpp
+  \brief    LIN-to-CAN gateway for LIN master emulation
+  \details  This library provides a gateway which maps LIN frames handled by a LIN_Master to CAN
+            messages and vice versa via a routing table. The CAN bus is accessed via a pluggable
+            driver interface, e.g. an MCP2515 controller or an in-process virtual CAN for testing.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_gateway.h"
+#include "LIN_atomic.h"
+
+
+/**************************
+ * virtual CAN driver
+ **************************/
+
+/**
+  \brief      Constructor for virtual CAN driver
+  \details    Constructor for virtual CAN driver. Initially the driver is in loopback mode.
+*/
+LIN_CAN_Virtual::LIN_CAN_Virtual()
+{
+  // loopback mode, empty queue
+  peer   = NULL;
+  headRx = 0;
+  tailRx = 0;
+
+} // LIN_CAN_Virtual::LIN_CAN_Virtual()
+
+
+
+/**
+  \brief      Connect to peer driver
+  \details    Connect to another virtual CAN driver. Messages sent are received by the peer.
+  \param[in]  Peer        peer driver
+*/
+void LIN_CAN_Virtual::connect(LIN_CAN_Virtual &Peer)
+{
+  // connect both directions
+  peer      = &Peer;
+  Peer.peer = this;
+
+} // LIN_CAN_Virtual::connect()
+
+
+
+/**
+  \brief      Put message into receive queue
+  \details    Put message into receive queue, e.g. to simulate CAN reception in tests.
+  \param[in]  msg         CAN message
+  \return     false if receive queue is full
+*/
+bool LIN_CAN_Virtual::inject(const LIN_CAN_message_t &msg)
+{
+  uint8_t  next = (headRx + 1) % LIN_CAN_VIRTUAL_DEPTH;
+
+  // queue full -> drop message
+  if (next == tailRx)
+    return false;
+
+  // store message
+  bufRx[headRx] = msg;
+  headRx = next;
+
+  return true;
+
+} // LIN_CAN_Virtual::inject()
+
+
+
+/**
+  \brief      Send CAN message
+  \details    Send CAN message to peer, or to own receive queue in loopback mode.
+  \param[in]  msg         CAN message
+  \return     false if receive queue of peer is full
+*/
+bool LIN_CAN_Virtual::send(const LIN_CAN_message_t &msg)
+{
+  // send to peer or loopback
+  if (peer != NULL)
+    return peer->inject(msg);
+  return inject(msg);
+
+} // LIN_CAN_Virtual::send()
+
+
+
+/**
+  \brief      Fetch received CAN message
+  \details    Fetch oldest message from receive queue.
+  \param[out] msg         CAN message
+  \return     false if no message is available
+*/
+bool LIN_CAN_Virtual::receive(LIN_CAN_message_t &msg)
+{
+  // queue empty
+  if (headRx == tailRx)
+    return false;
+
+  // fetch message
+  msg = bufRx[tailRx];
+  tailRx = (tailRx + 1) % LIN_CAN_VIRTUAL_DEPTH;
+
+  return true;
+
+} // LIN_CAN_Virtual::receive()
+
+
+
+/**************************
+ * LIN-to-CAN gateway
+ **************************/
+
+/**
+  \brief      Constructor for LIN-to-CAN gateway
+  \details    Constructor for LIN-to-CAN gateway. Store LIN master, CAN driver and routing table.
+  \param[in]  Lin         LIN master instance
+  \param[in]  Can         CAN driver
+  \param[in]  Routes      routing table. Must remain valid while gateway is active
+  \param[in]  NumRoutes   number of routes in table
+*/
+LIN_Gateway::LIN_Gateway(LIN_Master &Lin, LIN_CAN_Driver &Can, LIN_gateway_route_t *Routes, uint8_t NumRoutes)
+{
+  // store parameters
+  pLIN      = &Lin;
+  pCAN      = &Can;
+  routes    = Routes;
+  numRoutes = NumRoutes;
+
+  // reset internal variables
+  headTx     = 0;
+  tailTx     = 0;
+  lockCAN    = false;
+  numLostCAN = 0;
+
+} // LIN_Gateway::LIN_Gateway()
+
+
+
+/**
+  \brief      Start gateway
+  \details    Attach gateway to LIN master. Afterwards all successful LIN frames are checked against the routing table.
+*/
+void LIN_Gateway::begin(void)
+{
+  // route LIN frames to gateway
+  pLIN->attachFrameHook(frameHook, this);
+
+} // LIN_Gateway::begin()
+
+
+
+/**
+  \brief      Stop gateway
+  \details    Detach gateway from LIN master.
+*/
+void LIN_Gateway::end(void)
+{
+  // detach from LIN master
+  pLIN->attachFrameHook(NULL, NULL);
+
+} // LIN_Gateway::end()
+
+
+
+/**
+  \brief      Execute LIN frame of a route
+  \details    Execute the LIN frame of a route, typically called from the LIN schedule. For LIN_TO_CAN
+              routes a slave response is requested, which is forwarded to CAN on reception. For CAN_TO_LIN
+              routes the last received CAN data is sent as master request. If no CAN message was received
+              yet, the slot is skipped.
+  \param[in]  idx         index in routing table
+  \return     result of LIN frame
+*/
+LIN_error_t LIN_Gateway::handleSlot(uint8_t idx)
+{
+  LIN_gateway_route_t  *route;
+
+  // check index
+  if (idx >= numRoutes)
+    return LIN_ERROR_MISC;
+  route = &(routes[idx]);
+
+  // request slave response. Forwarding to CAN is done in frame hook
+  if (route->direction == LIN_TO_CAN)
+    return pLIN->receiveSlaveResponse(route->linId, route->numData, route->data);
+
+  // send last CAN data as master request
+  if (route->valid)
+    return pLIN->sendMasterRequest(route->linId, route->numData, route->data);
+
+  return LIN_SUCCESS;
+
+} // LIN_Gateway::handleSlot()
+
+
+
+/**
+  \brief      Forward LIN frame to CAN
+  \details    Forward a successful LIN frame to CAN if a matching LIN_TO_CAN route exists.
+              Is called from LIN_Master::handlerReceive() via frame hook.
+  \param[in]  id          frame ID (unprotected)
+  \param[in]  numData     number of data bytes
+  \param[in]  data        data bytes
+*/
+void LIN_Gateway::handleFrame(uint8_t id, uint8_t numData, uint8_t *data)
+{
+  LIN_CAN_message_t  msg;
+
+  // find matching route(s)
+  for (uint8_t i=0; i<numRoutes; i++)
+  {
+    if ((routes[i].direction != LIN_TO_CAN) || (routes[i].linId != id))
+      continue;
+
+    // forward frame to CAN
+    msg.id  = routes[i].canId;
+    msg.len = numData;
+    memcpy(msg.data, data, numData);
+    sendCAN(msg);
+
+  } // loop over routes
+
+} // LIN_Gateway::handleFrame()
+
+
+
+/**
+  \brief      Gateway background task
+  \details    Send CAN messages pending due to busy driver and store received CAN messages for matching
+              CAN_TO_LIN routes. Call periodically, e.g. from loop() or task scheduler.
+*/
+void LIN_Gateway::task(void)
+{
+  LIN_CAN_message_t  msg;
+
+  // lock CAN driver against access from frame hook
+  lockCAN = true;
+
+  // retry pending CAN transmissions in order
+  while (headTx != tailTx)
+  {
+    if (!pCAN->send(bufTx[tailTx]))
+      break;
+    tailTx = (tailTx + 1) % LIN_GATEWAY_QUEUE;
+  }
+
+  // drain CAN reception
+  while (pCAN->receive(msg))
+  {
+    for (uint8_t i=0; i<numRoutes; i++)
+    {
+      if ((routes[i].direction != CAN_TO_LIN) || (routes[i].canId != msg.id))
+        continue;
+
+      // store data for next LIN slot. Shorter CAN frame -> zero-fill, don't keep bytes of previous message.
+      // Avoid inconsistent data in case LIN master reads it concurrently
+      LIN_irq_t s = LIN_irqSave();
+      memset(routes[i].data, 0, routes[i].numData);
+      memcpy(routes[i].data, msg.data, min(msg.len, routes[i].numData));
+      routes[i].valid = true;
+      LIN_irqRestore(s);
+
+    } // loop over routes
+
+  } // CAN message received
+
+  // release CAN driver
+  lockCAN = false;
+
+} // LIN_Gateway::task()
+
+
+
+/**
+  \brief      Send CAN message or queue if busy
+  \details    Send CAN message. If driver is busy, used by task() or older messages are pending, queue it
+              to keep message order.
+  \param[in]  msg         CAN message
+  \return     false if message was lost
+*/
+bool LIN_Gateway::sendCAN(const LIN_CAN_message_t &msg)
+{
+  uint8_t  next;
+
+  // send directly if driver not in use and no older message pending
+  if ((!lockCAN) && (headTx == tailTx) && (pCAN->send(msg)))
+    return true;
+
+  // queue full -> message is lost
+  next = (headTx + 1) % LIN_GATEWAY_QUEUE;
+  if (next == tailTx)
+  {
+    numLostCAN++;
+    return false;
+  }
+
+  // queue message for task()
+  bufTx[headTx] = msg;
+  headTx = next;
+
+  return true;
+
+} // LIN_Gateway::sendCAN()
+
+
+
+/**
+  \brief      Frame hook for LIN_Master
+  \details    Static frame hook attached to LIN_Master. Forwards frame to the gateway instance.
+  \param[in]  Context     gateway instance
+  \param[in]  id          frame ID (unprotected)
+  \param[in]  numData     number of data bytes
+  \param[in]  data        data bytes
+*/
+void LIN_Gateway::frameHook(void *Context, uint8_t id, uint8_t numData, uint8_t *data)
+{
+  // call class method
+  ((LIN_Gateway*) Context)->handleFrame(id, numData, data);
+
+} // LIN_Gateway::frameHook()
@@ -0,0 +1,211 @@
+/**
+  \file     LIN_gateway.h
+  \brief    LIN-to-CAN gateway for LIN master emulation
+  \details  This library provides a gateway which maps LIN frames handled by a LIN_Master to CAN
+            messages and vice versa via a routing table. The CAN bus is accessed via a pluggable
+            driver interface, e.g. an MCP2515 controller or an in-process virtual CAN for testing.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_GATEWAY_H_
+#define _LIN_GATEWAY_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_GATEWAY_QUEUE     8         //!< depth of gateway CAN transmit queue (for busy CAN driver)
+#define LIN_CAN_VIRTUAL_DEPTH 8         //!< depth of virtual CAN receive queue
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief CAN message
+*/
+typedef struct {
+    uint32_t          id;           //!< CAN identifier (incl. optional driver flags, e.g. extended ID)
+    uint8_t           len;          //!< number of data bytes (0..8)
+    uint8_t           data[8];      //!< data bytes
+} LIN_CAN_message_t;
+
+
+/**
+    \brief direction of gateway route
+*/
+typedef enum {
+    LIN_TO_CAN        = 1,          //!< forward LIN frame to CAN
+    CAN_TO_LIN        = 2           //!< forward CAN message to LIN master request
+} LIN_route_t;
+
+
+/**
+    \brief entry of gateway routing table
+*/
+typedef struct {
+    uint8_t           linId;        //!< LIN frame ID (unprotected)
+    uint32_t          canId;        //!< CAN identifier
+    uint8_t           numData;      //!< number of data bytes (0..8)
+    LIN_route_t       direction;    //!< forwarding direction
+    uint8_t           data[8];      //!< runtime: last data received for this route. Initialize with 0
+    bool              valid;        //!< runtime: data is valid. Initialize with false
+} LIN_gateway_route_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASSES
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  CAN driver interface
+
+  \details Interface for CAN drivers used by LIN_Gateway. Implement send() and receive() for the used CAN controller.
+*/
+class LIN_CAN_Driver
+{
+  public:
+
+    // public methods
+    virtual bool      send(const LIN_CAN_message_t &msg) = 0;               //!< queue CAN message for transmission. Return false if busy
+    virtual bool      receive(LIN_CAN_message_t &msg) = 0;                  //!< fetch received CAN message. Return false if none available
+};
+
+
+
+/**
+  \brief  Virtual CAN driver
+
+  \details In-process CAN driver for testing without CAN hardware. Sent messages are received by the
+           connected peer, or by the driver itself (loopback) if no peer is connected.
+*/
+class LIN_CAN_Virtual : public LIN_CAN_Driver
+{
+  protected:
+
+    // internal variables
+    LIN_CAN_Virtual   *peer;                                                //!< connected peer (NULL = loopback)
+    LIN_CAN_message_t bufRx[LIN_CAN_VIRTUAL_DEPTH];                         //!< receive queue
+    volatile uint8_t  headRx;                                               //!< receive queue write index
+    volatile uint8_t  tailRx;                                               //!< receive queue read index
+
+  public:
+
+    // public methods
+    LIN_CAN_Virtual();                                                      //!< class constructor
+    void              connect(LIN_CAN_Virtual &Peer);                       //!< connect to peer driver
+    bool              inject(const LIN_CAN_message_t &msg);                 //!< put message into receive queue
+    bool              send(const LIN_CAN_message_t &msg);                   //!< send message to peer
+    bool              receive(LIN_CAN_message_t &msg);                      //!< fetch received message
+};
+
+
+
+/**
+  \brief  MCP2515 CAN driver adapter
+
+  \details Adapter for MCP2515 libraries with sendMessage()/readMessage() API, e.g.
+           https://github.com/autowp/arduino-mcp2515. Usage: LIN_CAN_MCP2515<MCP2515, can_frame> can(mcp2515);
+*/
+template <class MCP, class FRAME> class LIN_CAN_MCP2515 : public LIN_CAN_Driver
+{
+  protected:
+
+    // internal variables
+    MCP               &mcp;                                                 //!< used MCP2515 instance
+
+  public:
+
+    /// class constructor
+    LIN_CAN_MCP2515(MCP &Mcp) : mcp(Mcp) { }
+
+    /// queue CAN message for transmission
+    bool send(const LIN_CAN_message_t &msg)
+    {
+      FRAME frame;
+      frame.can_id  = msg.id;
+      frame.can_dlc = msg.len;
+      memcpy(frame.data, msg.data, msg.len);
+      return (mcp.sendMessage(&frame) == MCP::ERROR_OK);
+    }
+
+    /// fetch received CAN message
+    bool receive(LIN_CAN_message_t &msg)
+    {
+      FRAME frame;
+      if (mcp.readMessage(&frame) != MCP::ERROR_OK)
+        return false;
+      msg.id  = frame.can_id;
+      msg.len = (frame.can_dlc > 8) ? 8 : frame.can_dlc;
+      memcpy(msg.data, frame.data, msg.len);
+      return true;
+    }
+};
+
+
+
+/**
+  \brief  LIN-to-CAN gateway
+
+  \details Gateway between a LIN_Master and a CAN driver. LIN frames are forwarded to CAN directly
+           from the LIN receive handler. Received CAN messages are stored and sent as master requests
+           in the LIN slot of the respective route, see handleSlot().
+*/
+class LIN_Gateway
+{
+  protected:
+
+    // internal variables
+    LIN_Master          *pLIN;                                              //!< pointer to LIN master
+    LIN_CAN_Driver      *pCAN;                                              //!< pointer to CAN driver
+    LIN_gateway_route_t *routes;                                            //!< routing table
+    uint8_t             numRoutes;                                          //!< number of routes
+    LIN_CAN_message_t   bufTx[LIN_GATEWAY_QUEUE];                           //!< CAN messages pending due to busy driver
+    volatile uint8_t    headTx;                                             //!< transmit queue write index
+    volatile uint8_t    tailTx;                                             //!< transmit queue read index
+    volatile bool       lockCAN;                                            //!< CAN driver in use by task()
+
+    // internal methods
+    static void         frameHook(void *Context, uint8_t id, uint8_t numData, uint8_t *data);  //!< hook for LIN_Master
+    bool                sendCAN(const LIN_CAN_message_t &msg);              //!< send CAN message or queue if busy
+
+  public:
+
+    // public variables
+    uint16_t            numLostCAN;                                         //!< number of CAN messages lost due to full queue
+
+    // public methods
+    LIN_Gateway(LIN_Master &Lin, LIN_CAN_Driver &Can, LIN_gateway_route_t *Routes, uint8_t NumRoutes);  //!< class constructor
+    void                begin(void);                                        //!< attach gateway to LIN master
+    void                end(void);                                          //!< detach gateway from LIN master
+    LIN_error_t         handleSlot(uint8_t idx);                            //!< execute LIN frame of route idx
+    void                handleFrame(uint8_t id, uint8_t numData, uint8_t *data);  //!< forward LIN frame to CAN
+    void                task(void);                                         //!< poll CAN reception and pending transmissions
+
+    // observer hooks, see LIN_observer.h. Use instead of begin() for compile-time observer chains
+    inline void         onReceiveStart(LIN_Master&) { }                     //!< observer hook: receive handler start (unused)
+    inline void         onFrameComplete(LIN_Master&, uint8_t id, uint8_t numData, uint8_t *data) { handleFrame(id, numData, data); }  //!< observer hook: forward frame
+    inline void         onFrameError(LIN_Master&, LIN_error_t) { }          //!< observer hook: frame error (unused)
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_GATEWAY_H_
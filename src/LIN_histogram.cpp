@@ -0,0 +1,169 @@
+/**
+  \file     LIN_histogram.cpp
+  \brief    Streaming percentile estimator for LIN timing statistics
+  \details  This library provides a constant-memory log histogram for durations in us. It gives p50/p99/max of an
+            unbounded sample stream in 21 bytes, i.e. tail behaviour can be tracked on AVR without storing samples.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_histogram.h"
+
+
+/**
+  \brief      Constructor for log histogram
+  \details    Constructor for log histogram. Histogram is empty.
+*/
+LIN_Histogram::LIN_Histogram()
+{
+  reset();
+
+} // LIN_Histogram::LIN_Histogram()
+
+
+
+/**
+  \brief      Delete all samples
+  \details    Delete all samples and reset maximum.
+*/
+void LIN_Histogram::reset(void)
+{
+  memset(count, 0, LIN_HISTOGRAM_BINS);
+  maxValue = 0;
+
+} // LIN_Histogram::reset()
+
+
+
+/**
+  \brief      Bin index of a value
+  \details    Bin 0 holds values <128us. Above, each octave [2^e, 2^(e+1)) is split into two bins by the bit below the MSB.
+  \param[in]  value       sample [us]
+  \return     bin index
+*/
+uint8_t LIN_Histogram::bin(uint16_t value)
+{
+  uint8_t  e = 15;
+
+  // small values
+  if (value < 128)
+    return 0;
+
+  // find MSB, then use next bit for half-octave
+  while (!(value & (1U << e)))
+    e--;
+  return 1 + 2*(e-7) + ((value >> (e-1)) & 0x01);
+
+} // LIN_Histogram::bin()
+
+
+
+/**
+  \brief      Upper bound of a bin
+  \details    Upper bound of a bin, saturated to 16 bit.
+  \param[in]  idx         bin index
+  \return     upper bound [us]
+*/
+uint16_t LIN_Histogram::upperBound(uint8_t idx)
+{
+  uint8_t   e;
+  uint32_t  bound;
+
+  // small values
+  if (idx == 0)
+    return 128;
+
+  // lower half of octave ends at 1.5*2^e, upper half at 2^(e+1)
+  e     = 7 + (idx-1)/2;
+  bound = (uint32_t) (3 + ((idx-1) & 0x01)) << (e-1);
+  return (bound > 0xFFFF) ? 0xFFFF : (uint16_t) bound;
+
+} // LIN_Histogram::upperBound()
+
+
+
+/**
+  \brief      Add sample
+  \details    Add sample to histogram. If the bin counter would overflow, all counters are halved first.
+  \param[in]  value       sample [us]
+*/
+void LIN_Histogram::add(uint16_t value)
+{
+  uint8_t  idx = bin(value);
+
+  // counter overflow -> fade out old samples. Round up to keep rare bins
+  if (count[idx] == 255)
+  {
+    for (uint8_t i=0; i<LIN_HISTOGRAM_BINS; i++)
+      count[i] = (count[i] + 1) >> 1;
+  }
+
+  // add sample
+  count[idx]++;
+  if (value > maxValue)
+    maxValue = value;
+
+} // LIN_Histogram::add()
+
+
+
+/**
+  \brief      Estimate percentile
+  \details    Estimate percentile as upper bound of the bin containing it, limited to the maximum sample.
+              I.e. the estimate is conservative by less than a half-octave.
+  \param[in]  p           percentile (1..100), e.g. 50 for median
+  \return     estimated percentile [us], or 0 if no samples
+*/
+uint16_t LIN_Histogram::percentile(uint8_t p)
+{
+  uint16_t  total = getCount();
+  uint16_t  target, sum = 0;
+
+  // no samples
+  if (total == 0)
+    return 0;
+
+  // find bin containing the p-th percentile (rounded up)
+  target = (uint16_t) (((uint32_t) total * p + 99) / 100);
+  for (uint8_t i=0; i<LIN_HISTOGRAM_BINS; i++)
+  {
+    sum += count[i];
+    if (sum >= target)
+      return (upperBound(i) < maxValue) ? upperBound(i) : maxValue;
+  }
+  return maxValue;
+
+} // LIN_Histogram::percentile()
+
+
+
+/**
+  \brief      Get maximum sample
+  \details    Get maximum sample since last reset(). Is not faded out.
+  \return     maximum sample [us]
+*/
+uint16_t LIN_Histogram::getMax(void)
+{
+  return maxValue;
+
+} // LIN_Histogram::getMax()
+
+
+
+/**
+  \brief      Get number of samples
+  \details    Get number of samples. After counter overflow this is the scaled number of samples.
+  \return     (scaled) number of samples
+*/
+uint16_t LIN_Histogram::getCount(void)
+{
+  uint16_t  total = 0;
+
+  for (uint8_t i=0; i<LIN_HISTOGRAM_BINS; i++)
+    total += count[i];
+  return total;
+
+} // LIN_Histogram::getCount()
@@ -0,0 +1,70 @@
+/**
+  \file     LIN_histogram.h
+  \brief    Streaming percentile estimator for LIN timing statistics
+  \details  This library provides a constant-memory log histogram for durations in us. It gives p50/p99/max of an
+            unbounded sample stream in 21 bytes, i.e. tail behaviour can be tracked on AVR without storing samples.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_HISTOGRAM_H_
+#define _LIN_HISTOGRAM_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_HISTOGRAM_BINS  19          //!< bins: <128us, then 2 bins per octave up to 65.5ms
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Log histogram of durations
+
+  \details Log histogram with half-octave bins, i.e. percentiles are resolved within +/-20%. Counters are 8 bit.
+           If a counter overflows, all counters are halved, i.e. old samples fade out while the shape of the
+           distribution is kept. Non-empty bins stay non-empty, so rare tail samples are not lost.
+*/
+class LIN_Histogram
+{
+  protected:
+
+    // internal variables
+    uint8_t           count[LIN_HISTOGRAM_BINS];                            //!< (scaled) number of samples per bin
+    uint16_t          maxValue;                                             //!< maximum sample [us]
+
+    // internal methods
+    static uint8_t    bin(uint16_t value);                                  //!< bin index of a value
+    static uint16_t   upperBound(uint8_t idx);                              //!< upper bound of a bin [us]
+
+  public:
+
+    // public methods
+    LIN_Histogram();                                                        //!< class constructor
+    void              reset(void);                                          //!< delete all samples
+    void              add(uint16_t value);                                  //!< add sample [us]
+    uint16_t          percentile(uint8_t p);                                //!< estimate percentile [us]
+    uint16_t          getMax(void);                                         //!< get maximum sample [us]
+    uint16_t          getCount(void);                                       //!< get (scaled) number of samples
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_HISTOGRAM_H_
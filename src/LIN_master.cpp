@@ -11,6 +11,9 @@
 // include files
 #include "Arduino.h"
 #include "LIN_master.h"
+#include "LIN_frame.h"
+#include "LIN_registry.h"
+#include "LIN_e2e.h"
 
 
 /**
@@ -39,6 +42,21 @@ void LIN_Master::begin(uint16_t Baudrate=19200, LIN_version_t Version=LIN_V2, bo
   // reset internal variables
   error = LIN_SUCCESS;       // last LIN error. Is latched
   state = LIN_STATE_IDLE;    // status of LIN state machine
+  timingActive = false;      // nominal timing
+  echo = true;               // read back and check LIN echo
+  slotGuard = false;         // report overlapping frames as error
+  breakSent = false;         // no frame on the bus
+  numOverrun = 0;            // number of aborted frames
+  fault = LIN_FAULT_NONE;    // no bus fault detected
+  countFault = 0;            // no consecutive bus faults
+  probe = false;             // no bus scan probe ongoing
+  injectFaults = 0;          // no fault injected into current frame
+  #if (LIN_TRACE != 0)
+    traceBus = LIN_trace.registerBus(this);  // index for execution trace
+  #endif
+  pTx = bufTx;               // send from internal buffer
+  seqResult = 0;             // no frame result yet
+  memset(&result, 0, sizeof(LIN_result_t));
 
   // initialize serial interface
   pSerial->begin(Baudrate); while(!(*pSerial));
@@ -107,6 +125,23 @@ uint8_t LIN_Master::protectID(uint8_t id)
   \return     calculated frame checksum
 */
 uint8_t LIN_Master::checksum(uint8_t id, uint8_t numData, uint8_t *data)
+{
+  return checksum(id, numData, data, version);
+
+} // LIN_Master::checksum()
+
+
+
+/**
+  \brief      Calculate LIN frame checksum for a given LIN version.
+  \details    Method to calculate the LIN frame checksum as described in LIN2.0 spec, e.g. to detect the checksum model of unknown frames
+  \param[in]  id          frame ID
+  \param[in]  numData     number of data bytes in frame
+  \param[in]  data        buffer containing data bytes
+  \param[in]  Version     LIN_V1 for classic or LIN_V2 for enhanced checksum
+  \return     calculated frame checksum
+*/
+uint8_t LIN_Master::checksum(uint8_t id, uint8_t numData, uint8_t *data, LIN_version_t Version)
 {
   uint16_t chk=0x00;
 
@@ -116,7 +151,7 @@ uint8_t LIN_Master::checksum(uint8_t id, uint8_t numData, uint8_t *data)
   // LIN2.x uses extended checksum which includes protected ID, i.e. including parity bits
   // LIN1.x uses classical checksum only over data bytes
   // Diagnostic frames with ID 0x3C and 0x3D/0x7D always use classical checksum (see LIN spec "2.3.1.5 Checkum")
-  if (!((version == LIN_V1) || (id == 0x3C) || (id == 0x7D)))    // if version 2  & no diagnostic frames (0x3C=60 (PID=0x3C) or 0x3D=61 (PID=0x7D))
+  if (!((Version == LIN_V1) || (id == 0x3C) || (id == 0x7D)))    // if version 2  & no diagnostic frames (0x3C=60 (PID=0x3C) or 0x3D=61 (PID=0x7D))
     chk = (uint16_t) id;
 
   // loop over data bytes
@@ -136,48 +171,61 @@ uint8_t LIN_Master::checksum(uint8_t id, uint8_t numData, uint8_t *data)
 
 
 /**
-  \brief      send a master request frame.
-  \details    Send a master request frame. Actual transmission is handled by task scheduler for background operation.
-              For an explanation of the LIN bus and protocoll e.g. see https://en.wikipedia.org/wiki/Local_Interconnect_Network.
-  \param[in]  id          frame ID (protection optional)
-  \param[in]  numData     number of data bytes (0..8)
-  \param[in]  data        Tx data bytes
+  \brief      Prepare start of a master request frame.
+  \details    Check state of LIN state machine and bus fault state before a master request is assembled.
+  \return     LIN_SUCCESS if frame may start
 */
-LIN_error_t LIN_Master::sendMasterRequest(uint8_t id, uint8_t numData, uint8_t *data)
+LIN_error_t LIN_Master::prepareMasterRequest(void)
 {
-  // return immediately if LIN state machine not in idle state
-  if (state != LIN_STATE_IDLE)
+  // claim state machine atomically, i.e. concurrent frame starts from loop() and task scheduler are safe
+  if (!LIN_atomicCAS(state, LIN_STATE_IDLE, LIN_STATE_BREAK))
+  {
+    // slot guard -> abort previous frame and start this frame on time. Only abort a frame which is on the bus,
+    // not one which another context has just claimed and is still assembling
+    if ((slotGuard) && ((state == LIN_STATE_FRAME) || ((state == LIN_STATE_BREAK) && (breakSent))))
+      abortFrame();
+
+    // else (or if another frame was started meanwhile) return immediately
+    if ((!slotGuard) || (!LIN_atomicCAS(state, LIN_STATE_IDLE, LIN_STATE_BREAK)))
+    {
+      // for printing error message, set debug level >=1
+      #if (LIN_DEBUG_LEVEL >= 1)
+        LIN_DEBUG_SERIAL.print(millis());
+        LIN_DEBUG_SERIAL.print("ms ");
+        LIN_DEBUG_SERIAL.print(serialName);
+        LIN_DEBUG_SERIAL.print(".sendMasterRequest(): state != LIN_STATE_IDLE (is ");
+        LIN_DEBUG_SERIAL.print(state);
+        LIN_DEBUG_SERIAL.println(")");
+      #endif
+      // state machine is owned by running frame -> don't touch state or buffers, see abortFrame() for recovery
+      LIN_atomicOr(error, LIN_ERROR_STATE);
+      return LIN_ERROR_STATE;
+    }
+  }
+
+  // bus fault -> skip frame, except for periodic probe. Release state machine
+  if (checkBusFault())
   {
-    // for printing error message, set debug level >=1
-    #if (LIN_DEBUG_LEVEL >= 1)
-      LIN_DEBUG_SERIAL.print(millis());
-      LIN_DEBUG_SERIAL.print("ms ");
-      LIN_DEBUG_SERIAL.print(serialName);
-      LIN_DEBUG_SERIAL.print(".sendMasterRequest(): state != LIN_STATE_IDLE (is ");
-      LIN_DEBUG_SERIAL.print(state);
-      LIN_DEBUG_SERIAL.println(")");
-    #endif
-    error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_STATE);
     state = LIN_STATE_IDLE;
-    memset(bufRx, 0, lenRx);
-    return LIN_ERROR_STATE;
+    return LIN_ERROR_FAULT;
   }
 
   // set master request frame type
   frameType = LIN_MASTER_REQUEST;
 
-  // protect ID
-  id = protectID(id);
+  return LIN_SUCCESS;
 
-  // construct frame: BREAK + SYNC + ID + DATA + CHK. Note: BREAK is handled outside
-  bufTx[0] = 0x00;                                // sync break
-  bufTx[1] = 0x55;                                // sync field
-  bufTx[2] = id;                                  // protected ID
-  memcpy(bufTx+3, data, numData);                 // data bytes
-  bufTx[3+numData] = checksum(id, numData, data); // frame checksum
-  lenTx = numData+4;                              // number of bytes to send (BREAK + SYNC + ID + DATA + CHK)
-  lenRx = lenTx;                                  // number of bytes to receive (BREAK + SYNC + ID + DATA + CHK)
+} // LIN_Master::prepareMasterRequest()
 
+
+
+/**
+  \brief      Start an assembled master request frame.
+  \details    Send sync break and start transmission of the frame assembled in pTx.
+  \return     LIN_SUCCESS if frame started
+*/
+LIN_error_t LIN_Master::startMasterRequest(void)
+{
   // for printing data to send, set debug level >=2
   #if (LIN_DEBUG_LEVEL >= 2)
     LIN_DEBUG_SERIAL.print(millis());
@@ -189,37 +237,34 @@ LIN_error_t LIN_Master::sendMasterRequest(uint8_t id, uint8_t numData, uint8_t *
     for (uint8_t i=0; i<lenTx; i++)
     {
       LIN_DEBUG_SERIAL.print(" 0x");
-      LIN_DEBUG_SERIAL.print(bufTx[i], HEX);
+      LIN_DEBUG_SERIAL.print(pTx[i], HEX);
     }
     LIN_DEBUG_SERIAL.println();
   #endif
 
-  // clear receive buffer (required to recover from error)
-  while (pSerial->available())
-    pSerial->read();
-
-  // set half baudrate for LIN break
-  #if defined(__AVR__)
-    *UCSRA &= ~(1<<U2X0);                              // on AVR clear "double baudrate"
-  #else
-    pSerial->begin(baudrate/2); while(!(*pSerial));    // else use built-in function
-  #endif
-
-  // send sync break (=0x00 at 1/2 baudrate)
-  pSerial->write((uint8_t) bufTx[0]);
-
-  // set new state of LIN state machine
-  state = LIN_STATE_BREAK;
+  // send sync break. State machine was already claimed as LIN_STATE_BREAK at frame start
+  sendBreak();
 
 
   // background operation -> use task scheduler
-  if (background)
+  if ((background) && (!timingActive))
   {
     // attach send handler for frame body
     Tasks_Add((Task) wrapperSend, 0, durationBreak);
 
   } // background operation
 
+  // spec-limit timing -> send header without delay, then continue in background
+  else if (background)
+  {
+    // wait until break has been sent
+    pSerial->flush();
+
+    // call send handler manually. Attaches receive handler
+    wrapperSend();
+
+  } // spec-limit timing
+
   // blocking operation -> call handlers manually
   else
   {
@@ -237,41 +282,203 @@ LIN_error_t LIN_Master::sendMasterRequest(uint8_t id, uint8_t numData, uint8_t *
 
   } // blocking operation
 
+  // frame started successfully. For blocking operation errors are latched in error
+  return LIN_SUCCESS;
+
+} // LIN_Master::startMasterRequest()
+
+
+
+/**
+  \brief      send a master request frame.
+  \details    Send a master request frame. Actual transmission is handled by task scheduler for background operation.
+              For an explanation of the LIN bus and protocoll e.g. see https://en.wikipedia.org/wiki/Local_Interconnect_Network.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  numData     number of data bytes (0..8)
+  \param[in]  data        Tx data bytes
+*/
+LIN_error_t LIN_Master::sendMasterRequest(uint8_t id, uint8_t numData, uint8_t *data)
+{
+  LIN_error_t  result;
+
+  // check state machine and bus fault
+  result = prepareMasterRequest();
+  if (result != LIN_SUCCESS)
+    return result;
+
+  // protect ID
+  id = protectID(id);
+
+  // construct frame: BREAK + SYNC + ID + DATA + CHK. Note: BREAK is handled outside
+  bufTx[0] = 0x00;                                // sync break
+  bufTx[1] = 0x55;                                // sync field
+  bufTx[2] = id;                                  // protected ID
+  memcpy(bufTx+3, data, numData);                 // data bytes
+  if (e2e != NULL)
+    e2e->protect(id, numData, bufTx+3);           // optional E2E counter and CRC
+  bufTx[3+numData] = checksum(id, numData, bufTx+3); // frame checksum
+  pTx   = bufTx;                                  // send from internal buffer
+  lenTx = numData+4;                              // number of bytes to send (BREAK + SYNC + ID + DATA + CHK)
+  lenRx = lenTx;                                  // number of bytes to receive (BREAK + SYNC + ID + DATA + CHK)
+
+  // start frame
+  return startMasterRequest();
+
 } // LIN_Master::sendMasterRequest
 
 
 
 /**
-  \brief      Receive slave response frame with callback function
-  \details    Receive a slave response and use callback function for handling received data.
+  \brief      send a master request frame from a signal store.
+  \details    Send a master request frame from a signal store, see LIN_frame.h. The frame is assembled in the store
+              itself, and only data bytes changed since the last call are copied. The checksum is updated incrementally
+              for these bytes, i.e. an unchanged frame is sent without any copying or checksum calculation.
+  \param[in]  Frame       signal store of frame. Must remain valid until transmission is complete
+*/
+LIN_error_t LIN_Master::sendMasterRequest(LIN_Frame &Frame)
+{
+  LIN_error_t  result;
+  uint8_t      pid, dirty, old;
+  uint16_t     sum;
+  bool         protect;
+
+  // check state machine and bus fault
+  result = prepareMasterRequest();
+  if (result != LIN_SUCCESS)
+    return result;
+
+  // first assembly or LIN version changed -> set header and recalculate checksum
+  pid = protectID(Frame.id);
+  if (Frame.versionChk != (uint8_t) version)
+  {
+    Frame.buf[0] = 0x00;                          // sync break
+    Frame.buf[1] = 0x55;                          // sync field
+    Frame.buf[2] = pid;                           // protected ID
+    Frame.dirty |= 0xFF;
+  }
+
+  // copy dirty bytes and update raw data sum incrementally. Fetch dirty mask first, application may set bits meanwhile.
+  // E2E counter and CRC change every frame, i.e. protected frames are always updated
+  dirty   = LIN_atomicExchange(Frame.dirty, (uint8_t) 0x00);
+  protect = (e2e != NULL) && (Frame.numData >= 2) && (e2e->contains(Frame.id));
+  if ((dirty != 0x00) || (protect))
+  {
+    for (uint8_t i=0; i<Frame.numData; i++)
+    {
+      if (dirty & (1 << i))
+      {
+        old = Frame.buf[3+i];
+        Frame.buf[3+i] = Frame.data[i];
+        Frame.sum = Frame.sum - old + Frame.buf[3+i];
+      }
+    }
+
+    // insert E2E counter and CRC in assembled frame
+    if (protect)
+    {
+      Frame.sum -= Frame.buf[3] + Frame.buf[4];
+      e2e->protect(Frame.id, Frame.numData, Frame.buf+3);
+      Frame.sum += Frame.buf[3] + Frame.buf[4];
+    }
+
+    // fold raw sum with carry like checksum(). LIN2.x extended checksum includes PID, except diagnostic frames
+    sum = Frame.sum;
+    if (!((version == LIN_V1) || (pid == 0x3C) || (pid == 0x7D)))
+      sum += pid;
+    sum = (sum == 0) ? 0 : ((sum - 1) % 255) + 1;
+    Frame.buf[3+Frame.numData] = (uint8_t) (0xFF - (uint8_t) sum);
+    Frame.versionChk = (uint8_t) version;
+  }
+
+  // send from signal store
+  pTx   = Frame.buf;
+  lenTx = Frame.numData+4;                        // number of bytes to send (BREAK + SYNC + ID + DATA + CHK)
+  lenRx = lenTx;                                  // number of bytes to receive (BREAK + SYNC + ID + DATA + CHK)
+
+  // start frame
+  return startMasterRequest();
+
+} // LIN_Master::sendMasterRequest
+
+
+
+/**
+  \brief      send a registered master request frame.
+  \details    Send a master request frame with length and data registered for this frame ID, see attachRegistry().
+  \param[in]  id          frame ID (protection optional)
+  \return     LIN_ERROR_MISC if no registry is attached or frame ID is not registered
+*/
+LIN_error_t LIN_Master::sendMasterRequest(uint8_t id)
+{
+  const LIN_registry_entry_t  *entry;
+
+  // get registered length and data in O(1)
+  if ((registry == NULL) || ((entry = registry->get(id)) == NULL) || (entry->data == NULL))
+  {
+    LIN_atomicOr(error, LIN_ERROR_MISC);
+    return LIN_ERROR_MISC;
+  }
+
+  // send master request
+  return sendMasterRequest(id, entry->numData, entry->data);
+
+} // LIN_Master::sendMasterRequest
+
+
+
+/**
+  \brief      Start slave response frame
+  \details    Start a slave response frame. Received data is either copied directly to a buffer, or handled by a
+              callback function with or without context. Exactly one of Data, Callback or Handler is used.
               Actual transmission is handled by task scheduler for background operation.
               For an explanation of the LIN bus and protocoll e.g. see https://en.wikipedia.org/wiki/Local_Interconnect_Network.
   \param[in]  id          frame ID (protection optional)
   \param[in]  numData     number of data bytes (0..8)
-  \param[out] Rx_handler  callback function to handle received data
+  \param[out] Data        buffer to copy data to after reception, or NULL
+  \param[in]  Callback    callback function with context to handle received data, or NULL
+  \param[in]  Context     context pointer passed to Callback
+  \param[in]  Handler     callback function w/o context to handle received data, or NULL
+  \param[in]  Probe       bus scan probe, see startProbe()
 */
-LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, void (*Rx_handler)(uint8_t, uint8_t*))
+LIN_error_t LIN_Master::startSlaveResponse(uint8_t id, uint8_t numData, uint8_t *Data, LIN_callback_t Callback, void *Context, decoder_t Handler, bool Probe)
 {
-  // return immediately if LIN state machine not in idle state
-  if (state != LIN_STATE_IDLE)
+  // claim state machine atomically, i.e. concurrent frame starts from loop() and task scheduler are safe
+  if (!LIN_atomicCAS(state, LIN_STATE_IDLE, LIN_STATE_BREAK))
+  {
+    // slot guard -> abort previous frame and start this frame on time. Only abort a frame which is on the bus,
+    // not one which another context has just claimed and is still assembling
+    if ((slotGuard) && ((state == LIN_STATE_FRAME) || ((state == LIN_STATE_BREAK) && (breakSent))))
+      abortFrame();
+
+    // else (or if another frame was started meanwhile) return immediately
+    if ((!slotGuard) || (!LIN_atomicCAS(state, LIN_STATE_IDLE, LIN_STATE_BREAK)))
+    {
+      // for printing error message, set debug level >=1
+      #if (LIN_DEBUG_LEVEL >= 1)
+        LIN_DEBUG_SERIAL.print(millis());
+        LIN_DEBUG_SERIAL.print("ms ");
+        LIN_DEBUG_SERIAL.print(serialName);
+        LIN_DEBUG_SERIAL.print(".receiveSlaveResponse(): state != LIN_STATE_IDLE (is ");
+        LIN_DEBUG_SERIAL.print(state);
+        LIN_DEBUG_SERIAL.println(")");
+      #endif
+      // state machine is owned by running frame -> don't touch state or buffers, see abortFrame() for recovery
+      LIN_atomicOr(error, LIN_ERROR_STATE);
+      return LIN_ERROR_STATE;
+    }
+  }
+
+  // bus fault -> skip frame, except for periodic probe. Release state machine
+  if (checkBusFault())
   {
-    // for printing error message, set debug level >=1
-    #if (LIN_DEBUG_LEVEL >= 1)
-      LIN_DEBUG_SERIAL.print(millis());
-      LIN_DEBUG_SERIAL.print("ms ");
-      LIN_DEBUG_SERIAL.print(serialName);
-      LIN_DEBUG_SERIAL.print(".receiveSlaveResponse(): state != LIN_STATE_IDLE (is ");
-      LIN_DEBUG_SERIAL.print(state);
-      LIN_DEBUG_SERIAL.println(")");
-    #endif
-    error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_STATE);
     state = LIN_STATE_IDLE;
-    memset(bufRx, 0, lenRx);
-    return LIN_ERROR_STATE;
+    return LIN_ERROR_FAULT;
   }
 
-  // set slave response frame type
+  // set slave response frame type. Set probe flag only after state machine was claimed, else the send
+  // handler of a running frame would skip its receive handler
   frameType = LIN_SLAVE_RESPONSE;
+  probe     = Probe;
 
   // protect ID
   id = protectID(id);
@@ -280,6 +487,7 @@ LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, void (
   bufTx[0] = 0x00;                                // sync break
   bufTx[1] = 0x55;                                // sync field
   bufTx[2] = id;                                  // protected ID
+  pTx   = bufTx;                                  // send from internal buffer
   lenTx = 3;                                      // number of bytes to send (BREAK + SYNC + ID)
   lenRx = 4 + numData;                            // number of bytes to receive (BREAK + SYNC + ID + DATA + CHK)
 
@@ -299,35 +507,48 @@ LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, void (
     LIN_DEBUG_SERIAL.println();
   #endif
 
-  // clear receive buffer (required to recover from error)
-  while (pSerial->available())
-    pSerial->read();
+  // set buffer or callback function to handle received bytes when finished
+  dataPtr     = Data;
+  rx_callback = Callback;
+  rx_context  = Context;
+  rx_handler  = Handler;
 
-  // set half baudrate for LIN break
-  #if defined(__AVR__)
-    *UCSRA &= ~(1<<U2X0);                              // on AVR clear "double baudrate"
-  #else
-    pSerial->begin(baudrate/2); while(!(*pSerial));    // else use built-in function
-  #endif
+  // send sync break. State machine was already claimed as LIN_STATE_BREAK at frame start
+  sendBreak();
 
-  // set callback function to handle received bytes when finished
-  rx_handler = Rx_handler;
 
-  // send sync break (=0x00 at 1/2 baudrate)
-  pSerial->write((uint8_t) bufTx[0]);
+  // bus scan probe -> send header now. Response is polled via pollProbe()
+  if (probe)
+  {
+    // wait until break has been sent
+    pSerial->flush();
 
-  // set new state of LIN state machine
-  state = LIN_STATE_BREAK;
+    // call send handler manually. Doesn't attach receive handler
+    wrapperSend();
+    numProbeRx = 0;
+    tProbeRx   = micros();
 
+  } // bus scan probe
 
   // background operation -> use task scheduler
-  if (background)
+  else if ((background) && (!timingActive))
   {
     // attach send handler for frame body
     Tasks_Add((Task) wrapperSend, 0, durationBreak);
 
   } // background operation
 
+  // spec-limit timing -> send header without delay, then continue in background
+  else if (background)
+  {
+    // wait until break has been sent
+    pSerial->flush();
+
+    // call send handler manually. Attaches receive handler
+    wrapperSend();
+
+  } // spec-limit timing
+
   // blocking operation -> call handlers manually
   else
   {
@@ -339,17 +560,58 @@ LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, void (
 
     // wait until slave has responded (with timeout)
     uint32_t tStart = millis();
-    while ((pSerial->available() != lenRx-1) && ((millis() - tStart) < durationFrame));
+    uint8_t  numRx  = (echo) ? lenRx-1 : lenRx-3;
+    while ((pSerial->available() != numRx) && ((millis() - tStart) < durationFrame));
 
     // call receive handler manually
     wrapperReceive();
 
   } // blocking operation
 
+  // frame started successfully. For blocking operation errors are latched in error
+  return LIN_SUCCESS;
+
+} // LIN_Master::startSlaveResponse
+
+
+
+/**
+  \brief      Receive slave response frame with callback function
+  \details    Receive a slave response and use callback function for handling received data.
+              Actual transmission is handled by task scheduler for background operation.
+              For an explanation of the LIN bus and protocoll e.g. see https://en.wikipedia.org/wiki/Local_Interconnect_Network.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  numData     number of data bytes (0..8)
+  \param[out] Rx_handler  callback function to handle received data
+*/
+LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, void (*Rx_handler)(uint8_t, uint8_t*))
+{
+  // start frame with callback function
+  return startSlaveResponse(id, numData, NULL, NULL, NULL, Rx_handler);
+
 } // LIN_Master::receiveSlaveResponse (callback)
 
 
 
+/**
+  \brief      Receive slave response frame with context callback function
+  \details    Receive a slave response and use callback function with user context for handling received data,
+              e.g. to handle several frames with one function w/o global variables.
+              Actual transmission is handled by task scheduler for background operation.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  numData     number of data bytes (0..8)
+  \param[in]  Callback    callback function (context, numData, data) to handle received data
+  \param[in]  Context     context pointer passed to callback
+*/
+LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, LIN_callback_t Callback, void *Context)
+{
+  // start frame with context callback function
+  return startSlaveResponse(id, numData, NULL, Callback, Context, NULL);
+
+} // LIN_Master::receiveSlaveResponse (context callback)
+
+
+
 /**
   \brief      Receive slave response frame and copy to buffer
   \details    Receive a slave response and copy received data to specified buffer after reception.
@@ -357,128 +619,889 @@ LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, void (
               For an explanation of the LIN bus and protocoll e.g. see https://en.wikipedia.org/wiki/Local_Interconnect_Network.
   \param[in]  id          frame ID (protection optional)
   \param[in]  numData     number of data bytes (0..8)
-  \param[out] data        buffer to copy data to fater reception
+  \param[out] data        buffer to copy data to after reception
 */
 LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id, uint8_t numData, uint8_t *data)
 {
-  // store array pointer for default callback function
-  dataPtr = data;
-
-  // call receive function with callback for actual transmission
-  receiveSlaveResponse(id, numData, wrapperDefaultCallback);
+  // start frame with direct copy to buffer
+  return startSlaveResponse(id, numData, data, NULL, NULL, NULL);
 
 } // LIN_Master::receiveSlaveResponse (copy data)
 
 
 
 /**
-  \brief      Handler for LIN master transmission
-  \details    Handler for LIN master transmission. Here the remainder of the frame after sync break is sent.
+  \brief      receive a registered slave response frame.
+  \details    Receive a slave response frame with length registered for this frame ID, see attachRegistry().
+              Received data is dispatched via the registry from the received ID.
+  \param[in]  id          frame ID (protection optional)
+  \return     LIN_ERROR_MISC if no registry is attached or frame ID is not registered
 */
-void LIN_Master::handlerSend(void)
+LIN_error_t LIN_Master::receiveSlaveResponse(uint8_t id)
 {
-  // check state of state machine
-  if (state != LIN_STATE_BREAK)
+  const LIN_registry_entry_t  *entry;
+
+  // get registered length in O(1)
+  if ((registry == NULL) || ((entry = registry->get(id)) == NULL))
   {
-    // for printing error message, set debug level >=1
-    #if (LIN_DEBUG_LEVEL >= 1)
-      LIN_DEBUG_SERIAL.print(millis());
-      LIN_DEBUG_SERIAL.print("ms ");
-      LIN_DEBUG_SERIAL.print(serialName);
-      LIN_DEBUG_SERIAL.print(".handlerSend(): state != LIN_STATE_BREAK (is ");
-      LIN_DEBUG_SERIAL.print(state);
-      LIN_DEBUG_SERIAL.println(")");
-    #endif
-    error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_STATE);
-    state = LIN_STATE_IDLE;
-    memset(bufRx, 0, lenRx);
-    return;
+    LIN_atomicOr(error, LIN_ERROR_MISC);
+    return LIN_ERROR_MISC;
   }
 
+  // start frame w/o handler -> dispatch via registry
+  return startSlaveResponse(id, entry->numData, NULL, NULL, NULL, NULL);
 
-  // wait until break received (with timeout) before changing baudrate
-  uint32_t tStart = micros();
-  while ((!(pSerial->available())) && ((micros() - tStart) < 500));
+} // LIN_Master::receiveSlaveResponse (registry)
 
 
-  // assert no timeout
-  if (!(pSerial->available()))
-  {
-    // for printing error message, set debug level >=1
-    #if (LIN_DEBUG_LEVEL >= 1)
-      LIN_DEBUG_SERIAL.print(millis());
-      LIN_DEBUG_SERIAL.print("ms ");
-      LIN_DEBUG_SERIAL.print(serialName);
-      LIN_DEBUG_SERIAL.println(".handlerSend(): receive BREAK timeout");
-    #endif
-    error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_TIMEOUT);
-    state = LIN_STATE_IDLE;
-    memset(bufRx, 0, lenRx);
-    return;
-  }
 
-  // assert correct echo
-  bufRx[0] = pSerial->read();
-  if (bufRx[0] != 0x00)
+/**
+  \brief      Set spec-limit timing
+  \details    Set timing parameters for the following frames, e.g. to qualify slave robustness at the edges
+              of the LIN timing spec. Parameters remain active until changed. With spec-limit timing the
+              header is sent without delay after the break (blocking). For tight header-to-header
+              spacing use blocking operation and start frames back-to-back.
+  \param[in]  Timing      timing parameters, or NULL to restore nominal timing
+*/
+void LIN_Master::setTiming(const LIN_timing_t *Timing)
+{
+  // restore nominal timing
+  if (Timing == NULL)
   {
-    // for printing error message, set debug level >=1
-    #if (LIN_DEBUG_LEVEL >= 1)
-      LIN_DEBUG_SERIAL.print(millis());
-      LIN_DEBUG_SERIAL.print("ms ");
-      LIN_DEBUG_SERIAL.print(serialName);
-      LIN_DEBUG_SERIAL.print(".handlerSend(): received BREAK != 0x00 (is ");
-      LIN_DEBUG_SERIAL.print(bufRx[0]);
-      LIN_DEBUG_SERIAL.println(")");
-    #endif
-    error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_ECHO);
-    state = LIN_STATE_IDLE;
-    memset(bufRx, 0, lenRx);
+    timingActive = false;
+    pSerial->begin(baudrate); while(!(*pSerial));
     return;
   }
 
-  // BREAK echo read successfully
-  else
-  {
-    #if (LIN_DEBUG_LEVEL >= 2)
-      LIN_DEBUG_SERIAL.print(millis());
-      LIN_DEBUG_SERIAL.print("ms ");
+  // store timing parameters. Break length is limited to >=10Tbit (0x00 = 9 low bits)
+  timing = *Timing;
+  if (timing.breakBits == 0)
+    timing.breakBits = 18;
+  else if (timing.breakBits < 10)
+    timing.breakBits = 10;
+
+  // limit baudrate deviation, else the frame baudrate overflows
+  if (timing.baudOffset > LIN_TIMING_OFFSET)
+    timing.baudOffset = LIN_TIMING_OFFSET;
+  else if (timing.baudOffset < -LIN_TIMING_OFFSET)
+    timing.baudOffset = -LIN_TIMING_OFFSET;
+  timingActive = true;
+
+} // LIN_Master::setTiming()
+
+
+
+/**
+  \brief      Set fault injection schedule
+  \details    Deliberately corrupt the following frames, e.g. to test error handling and recovery of slaves.
+              Each started frame with matching ID consumes the next table entry. Frames with other IDs are sent
+              unchanged. Frame content faults (checksum, parity, sync, truncation) are applied to a copy in bufTx,
+              i.e. signal stores remain intact. Break length and inter-byte delay faults require nominal timing.
+              Injected frames typically end with LIN_ERROR_TIMEOUT, as slaves ignore or don't respond to them.
+              Echo errors of injected frames are not counted as bus faults. An injected break is sent blocking.
+  \param[in]  Table       fault injection schedule. Must remain valid while in use. NULL to stop injection
+  \param[in]  Num         number of entries in table
+  \param[in]  Repeat      restart with first entry after last entry
+*/
+void LIN_Master::setInjection(const LIN_inject_t *Table, uint8_t Num, bool Repeat)
+{
+  // avoid inconsistent schedule if frames are started from task scheduler
+  LIN_irq_t s = LIN_irqSave();
+  injectTable  = (Num == 0) ? NULL : Table;
+  numInject    = Num;
+  idxInject    = 0;
+  injectRepeat = Repeat;
+  LIN_irqRestore(s);
+
+} // LIN_Master::setInjection()
+
+
+
+/**
+  \brief      Get injected faults
+  \details    Get faults injected into the last started frame, e.g. to correlate them with the frame result.
+  \return     injected faults, see LIN_inject_type_t
+*/
+uint8_t LIN_Master::getInjected(void)
+{
+  return injectFaults;
+
+} // LIN_Master::getInjected()
+
+
+
+/**
+  \brief      Get end of header
+  \details    Get estimated end of header (or of master request) of the current frame, i.e. start of the slave
+              response window. Used as reference for response handling latency, see LIN_Observer_Latency.
+  \return     end of header [us]
+*/
+uint32_t LIN_Master::getHeaderEnd(void)
+{
+  return tTxComplete;
+
+} // LIN_Master::getHeaderEnd()
+
+
+
+/**
+  \brief      Enable or disable LIN echo
+  \details    Enable or disable reading back the LIN echo. Disable for transceivers or wirings without
+              Rx loopback. Then master requests are not read back at all, and for slave responses only
+              the response bytes are received within the response window after the header has been sent.
+              Is reset to enabled by begin().
+  \param[in]  Echo        true = check echo (default), false = echo-less operation
+*/
+void LIN_Master::setEcho(bool Echo)
+{
+  // store echo mode
+  echo = Echo;
+
+} // LIN_Master::setEcho()
+
+
+
+/**
+  \brief      Get state of LIN state machine
+  \details    Get state of LIN state machine, e.g. to check if a new frame can be started.
+  \return     state of LIN state machine
+*/
+LIN_status_t LIN_Master::getState(void)
+{
+  return state;
+
+} // LIN_Master::getState()
+
+
+
+/**
+  \brief      Get latched errors
+  \details    Get errors latched since last clearError(). Errors are latched atomically.
+  \return     latched errors
+*/
+LIN_error_t LIN_Master::getError(void)
+{
+  return error;
+
+} // LIN_Master::getError()
+
+
+
+/**
+  \brief      Get and clear latched errors
+  \details    Get and clear latched errors in one atomic operation, i.e. errors latched by a task scheduler callback
+              meanwhile are not lost. Use instead of reading and resetting error.
+  \return     latched errors before clearing
+*/
+LIN_error_t LIN_Master::clearError(void)
+{
+  return LIN_atomicExchange(error, LIN_SUCCESS);
+
+} // LIN_Master::clearError()
+
+
+
+/**
+  \brief      Publish result of finished frame
+  \details    Publish result of finished frame for getResult(). Called from receive handler before state machine
+              is released. Writer side of a sequence lock, i.e. never blocks.
+  \param[in]  Error       error of this frame, or LIN_SUCCESS
+*/
+void LIN_Master::publishResult(LIN_error_t Error)
+{
+  // odd sequence -> result is being written
+  seqResult++;
+  LIN_ATOMIC_FENCE();
+
+  // store result
+  result.id      = pTx[2] & 0x3F;
+  result.type    = frameType;
+  result.numData = lenRx-4;
+  result.error   = Error;
+  memcpy(result.data, bufRx+3, result.numData);
+
+  // frame and response duration, saturated to 16 bit. No reception or background operation -> 0
+  result.timeFrame    = 0;
+  result.timeResponse = 0;
+  if (tDone != tFrameStart)
+  {
+    result.timeFrame = ((tDone - tFrameStart) > 0xFFFF) ? 0xFFFF : (uint16_t) (tDone - tFrameStart);
+    if ((frameType == LIN_SLAVE_RESPONSE) && ((int32_t) (tDone - tTxComplete) > 0))
+      result.timeResponse = ((tDone - tTxComplete) > 0xFFFF) ? 0xFFFF : (uint16_t) (tDone - tTxComplete);
+  }
+
+  // even sequence -> result is consistent
+  LIN_ATOMIC_FENCE();
+  seqResult++;
+
+  // caller releases state machine
+  LIN_TRACE_EVENT(LIN_TRACE_STATE, traceBus, LIN_STATE_IDLE);
+
+} // LIN_Master::publishResult()
+
+
+
+/**
+  \brief      Get result of last frame
+  \details    Get a consistent copy of the result of the last finished frame. Reader side of a sequence lock, i.e.
+              the copy is repeated if a frame finished meanwhile, and interrupts are never masked. Must not be called
+              from an interrupt which may preempt the receive handler. Compare the returned sequence number to detect
+              new results.
+  \param[out] Result      copy of last frame result
+  \return     sequence number of result, incremented by 2 for each frame
+*/
+uint8_t LIN_Master::getResult(LIN_result_t &Result)
+{
+  uint8_t  seq;
+
+  // repeat copy until no result was published meanwhile
+  do
+  {
+    seq = seqResult;
+    LIN_ATOMIC_FENCE();
+    memcpy(&Result, &result, sizeof(LIN_result_t));
+    LIN_ATOMIC_FENCE();
+  } while ((seq & 0x01) || (seq != seqResult));
+
+  return seq;
+
+} // LIN_Master::getResult()
+
+
+
+/**
+  \brief      Worst-case frame duration
+  \details    Worst-case duration until LIN master is idle again after starting a frame. For background operation
+              this is given by the task scheduler delays independent of numData (~8.5ms at 19.2kBaud, ~15.5ms below
+              12kBaud), else by the break (18Tbit + delimiter) plus 1.4 times the nominal header and response durations
+              (see LIN2.0 spec "2.3.2 Frame slots").
+  \param[in]  numData     number of data bytes (0..8)
+  \return     worst-case frame duration [us]
+*/
+uint32_t LIN_Master::frameDurationMax(uint8_t numData)
+{
+  // background operation -> busy until receive handler was called (+ max. wait in handler)
+  if ((background) && (!timingActive))
+    return ((uint32_t) durationBreak + durationFrame) * 1000L + 500;
+
+  // blocking operation -> break + 1.4*(sync + PID + DATA + CHK) [0.1Tbit]
+  return ((uint32_t) (190 + 14 * (20 + 10 * (numData+1))) * 100000L) / baudrate;
+
+} // LIN_Master::frameDurationMax()
+
+
+
+/**
+  \brief      Enable or disable slot guard
+  \details    Enable or disable the slot guard. If enabled and a new frame is started while the previous frame
+              is still ongoing, i.e. the previous frame exceeded its slot, the previous frame is aborted and
+              the new frame is started on time. The overrun is latched as LIN_ERROR_OVERRUN and counted in numOverrun.
+              If disabled, the new frame is rejected with LIN_ERROR_STATE (default).
+              Only frames on the bus (break sent) are aborted. A frame which another context has claimed but not
+              yet sent is not aborted, instead the new frame is rejected with LIN_ERROR_STATE. For deterministic
+              slot timing start all frames from a single context.
+  \param[in]  Guard       true = abort overrunning frames, false = reject new frame
+*/
+void LIN_Master::setSlotGuard(bool Guard)
+{
+  // store slot guard mode
+  slotGuard = Guard;
+
+} // LIN_Master::setSlotGuard()
+
+
+
+/**
+  \brief      Abort ongoing frame
+  \details    Abort an ongoing frame which exceeded its slot. Pending handlers are removed from task scheduler,
+              the UART is flushed and the overrun is recorded and published as result, i.e. every started frame
+              publishes exactly one result.
+*/
+void LIN_Master::abortFrame(void)
+{
+  // for printing error message, set debug level >=1
+  #if (LIN_DEBUG_LEVEL >= 1)
+    LIN_DEBUG_SERIAL.print(millis());
+    LIN_DEBUG_SERIAL.print("ms ");
+    LIN_DEBUG_SERIAL.print(serialName);
+    LIN_DEBUG_SERIAL.print(".abortFrame(): slot overrun (state ");
+    LIN_DEBUG_SERIAL.print(state);
+    LIN_DEBUG_SERIAL.println(")");
+  #endif
+
+  // remove pending handlers of previous frame
+  Tasks_Remove((Task) wrapperSend);
+  Tasks_Remove((Task) wrapperReceive);
+
+  // wait until ongoing byte has been sent, discard received bytes
+  pSerial->flush();
+  while (pSerial->available())
+    pSerial->read();
+
+  // record and publish overrun, then reset state machine
+  probe = false;
+  LIN_atomicOr(error, LIN_ERROR_OVERRUN);
+  numOverrun++;
+  tDone = tFrameStart;
+  publishResult(LIN_ERROR_OVERRUN);
+  breakSent = false;
+  state = LIN_STATE_IDLE;
+  LIN_TRACE_EVENT(LIN_TRACE_STATE, traceBus, LIN_STATE_IDLE);
+  memset(bufRx, 0, lenRx);
+
+} // LIN_Master::abortFrame()
+
+
+
+/**
+  \brief      Start probe of a frame ID for bus scan
+  \details    Send header of a frame ID with unknown response length. The response is polled via pollProbe() with
+              short baud-derived timeouts, i.e. probes of several masters can run concurrently from loop().
+  \param[in]  id          frame ID (protection optional)
+  \return     LIN_SUCCESS if header was sent
+*/
+LIN_error_t LIN_Master::startProbe(uint8_t id)
+{
+  // start header for max. frame length, actual length is detected from response
+  return startSlaveResponse(id, 8, NULL, NULL, NULL, NULL, true);
+
+} // LIN_Master::startProbe()
+
+
+
+/**
+  \brief      Poll probe of a frame ID
+  \details    Poll response to startProbe(). The probe is finished if no response byte was received within
+              LIN_PROBE_SPACE bit after the header, or no further byte within LIN_PROBE_GAP bit, or 9 bytes were received.
+              Response length and checksum model are then detected from the received bytes.
+  \param[out] Result      result of probe, only valid if finished
+  \return     true if probe is finished
+*/
+bool LIN_Master::pollProbe(LIN_probe_t &Result)
+{
+  uint8_t   num, numEcho, numResp, *data;
+  uint32_t  tNow = micros(), tLimit;
+
+  // no probe ongoing or header failed in send handler
+  if ((!probe) || (state != LIN_STATE_FRAME))
+  {
+    Result.id      = pTx[2] & 0x3F;
+    Result.numData = 0;
+    Result.model   = LIN_CHK_NONE;
+    Result.error   = (probe) ? result.error : LIN_ERROR_STATE;
+    probe = false;
+    return true;
+  }
+
+  // track time of last received byte
+  numEcho = (echo) ? 2 : 0;
+  num     = pSerial->available();
+  if (num != numProbeRx)
+  {
+    numProbeRx = num;
+    tProbeRx   = tNow;
+  }
+
+  // still waiting for response start or next byte
+  if (num < numEcho+9)
+  {
+    if (num <= numEcho)
+      tLimit = tTxComplete + ((uint32_t) LIN_PROBE_SPACE * 1000000L) / baudrate;
+    else
+      tLimit = tProbeRx + ((uint32_t) LIN_PROBE_GAP * 1000000L) / baudrate;
+    if ((int32_t) (tLimit - tNow) > 0)
+      return false;
+  }
+
+  // read received bytes, discard excess bytes
+  if (num > numEcho+9)
+    num = numEcho+9;
+  for (uint8_t i=0; i<num; i++)
+    bufRx[i] = pSerial->read();
+  while (pSerial->available())
+    pSerial->read();
+
+  // default: no response
+  Result.id      = pTx[2] & 0x3F;
+  Result.numData = 0;
+  Result.model   = LIN_CHK_NONE;
+  Result.error   = LIN_SUCCESS;
+
+  // header echo mismatch
+  if ((echo) && ((num < 2) || (memcmp(bufRx, pTx+1, 2) != 0)))
+    Result.error = LIN_ERROR_ECHO;
+
+  // response received -> last byte is checksum. Detect checksum model
+  else if (num > numEcho)
+  {
+    numResp        = num - numEcho;
+    data           = bufRx + numEcho;
+    Result.numData = numResp - 1;
+    Result.model   = LIN_CHK_INVALID;
+    memcpy(Result.data, data, Result.numData);
+    if (Result.numData > 0)
+    {
+      if (data[Result.numData] == checksum(pTx[2], Result.numData, data, LIN_V1))
+        Result.model = LIN_CHK_CLASSIC;
+      else if (data[Result.numData] == checksum(pTx[2], Result.numData, data, LIN_V2))
+        Result.model = LIN_CHK_ENHANCED;
+    }
+  }
+
+  // release state machine
+  probe = false;
+  state = LIN_STATE_IDLE;
+  LIN_TRACE_EVENT(LIN_TRACE_STATE, traceBus, LIN_STATE_IDLE);
+
+  return true;
+
+} // LIN_Master::pollProbe()
+
+
+
+/**
+  \brief      Record bus fault
+  \details    Record result of a frame echo check. After LIN_FAULT_THRESHOLD consecutive bus faults the instance
+              enters fault state, see checkBusFault(). A correct echo resets the fault state. Faults of frames
+              with injected faults are caused deliberately and are not counted.
+  \param[in]  Fault       detected bus fault, or LIN_FAULT_NONE for correct echo
+*/
+void LIN_Master::recordBusFault(LIN_fault_t Fault)
+{
+  // correct echo -> bus ok
+  if (Fault == LIN_FAULT_NONE)
+  {
+    countFault = 0;
+    fault      = LIN_FAULT_NONE;
+    return;
+  }
+
+  // injected fault -> no bus fault
+  if (injectFaults != 0)
+    return;
+
+  // count consecutive faults and enter fault state after threshold
+  if (countFault < 255)
+    countFault++;
+  if (countFault >= LIN_FAULT_THRESHOLD)
+  {
+    if (fault == LIN_FAULT_NONE)
+      tProbe = millis();
+    fault = Fault;
+  }
+
+} // LIN_Master::recordBusFault()
+
+
+
+/**
+  \brief      Check bus fault state before starting a frame
+  \details    In bus fault state frames are skipped w/o bus access to save CPU time. Only every LIN_FAULT_PROBE ms
+              a frame is started as probe, which resets the fault state on correct echo.
+  \return     true if frame must be skipped
+*/
+bool LIN_Master::checkBusFault(void)
+{
+  // no bus fault
+  if (fault == LIN_FAULT_NONE)
+    return false;
+
+  // use frame as probe
+  if ((millis() - tProbe) >= LIN_FAULT_PROBE)
+  {
+    tProbe = millis();
+    return false;
+  }
+
+  // skip frame
+  LIN_atomicOr(error, LIN_ERROR_FAULT);
+  return true;
+
+} // LIN_Master::checkBusFault()
+
+
+
+/**
+  \brief      Apply fault injection
+  \details    Apply next entry of fault injection schedule to the assembled frame. Called at frame start before the
+              break is sent. Frame is copied to bufTx first, if it is sent from a signal store.
+*/
+void LIN_Master::injectFault(void)
+{
+  const LIN_inject_t  *e;
+
+  // no injection or entry for other frame ID
+  injectFaults = 0;
+  if (injectTable == NULL)
+    return;
+  e = &(injectTable[idxInject]);
+  if ((e->id != 0xFF) && (e->id != (pTx[2] & 0x3F)))
+    return;
+
+  // consume entry
+  if (++idxInject >= numInject)
+  {
+    idxInject = 0;
+    if (!injectRepeat)
+      injectTable = NULL;
+  }
+  injectEntry  = e;
+  injectFaults = e->faults;
+  if ((e->breakBits < 10) || (timingActive))
+    injectFaults &= ~LIN_INJECT_BREAK;                   // invalid break length, or spec-limit timing active
+  if (injectFaults == 0)
+    return;
+
+  // don't corrupt signal store
+  if (pTx != bufTx)
+  {
+    memcpy(bufTx, pTx, lenTx);
+    pTx = bufTx;
+  }
+
+  // corrupt frame content
+  if ((injectFaults & LIN_INJECT_CHK) && (frameType == LIN_MASTER_REQUEST))
+    bufTx[lenTx-1] ^= 0xFF;
+  if (injectFaults & LIN_INJECT_PARITY)
+    bufTx[2] ^= 0x80;
+  if (injectFaults & LIN_INJECT_SYNC)
+    bufTx[1] = e->sync;
+  // truncate frame. Keep header and lenRx, i.e. with echo the missing bytes are reported as timeout
+  if (injectFaults & LIN_INJECT_TRUNCATE)
+  {
+    uint8_t  numMin = (frameType == LIN_MASTER_REQUEST) ? 3 : 2;
+    uint8_t  num    = (e->numBytes < numMin) ? numMin : e->numBytes;
+    if (num + 1 < lenTx)
+      lenTx = num + 1;
+  }
+
+} // LIN_Master::injectFault()
+
+
+
+/**
+  \brief      Send sync break
+  \details    Clear receive buffer and send sync break, i.e. 0x00 at reduced baudrate. Nominal break length is 18Tbit
+              (1/2 baudrate). For spec-limit timing the baudrate is set according to the requested break length.
+*/
+void LIN_Master::sendBreak(void)
+{
+  // state machine was claimed as LIN_STATE_BREAK by caller
+  LIN_TRACE_EVENT(LIN_TRACE_STATE, traceBus, LIN_STATE_BREAK);
+
+  // optional fault injection
+  injectFault();
+
+  // start of frame for timing statistics
+  tFrameStart = micros();
+  tDone       = tFrameStart;
+
+  // clear receive buffer (required to recover from error)
+  while (pSerial->available())
+    pSerial->read();
+
+  // spec-limit timing: 0x00 has 9 low bits -> baudrate = 9/breakBits * frame baudrate
+  if (timingActive)
+  {
+    uint32_t  baudFrame = ((uint32_t) baudrate * (1000 + timing.baudOffset)) / 1000;
+    pSerial->begin((baudFrame * 9) / timing.breakBits); while(!(*pSerial));
+  }
+
+  // injected break length: 0x00 has 9 low bits
+  else if (injectFaults & LIN_INJECT_BREAK)
+  {
+    pSerial->begin(((uint32_t) baudrate * 9) / injectEntry->breakBits); while(!(*pSerial));
+  }
+
+  // set half baudrate for LIN break
+  else
+  {
+    #if defined(__AVR__)
+      *UCSRA &= ~(1<<U2X0);                              // on AVR clear "double baudrate"
+    #else
+      pSerial->begin(baudrate/2); while(!(*pSerial));    // else use built-in function
+    #endif
+  }
+
+  // send sync break (=0x00 at reduced baudrate). Frame is now on the bus, i.e. slot guard may abort it
+  pSerial->write((uint8_t) pTx[0]);
+  breakSent = true;
+
+} // LIN_Master::sendBreak()
+
+
+
+/**
+  \brief      Attach hook for successful frames
+  \details    Attach a hook which is called after each successfully sent master request or received
+              slave response, e.g. to forward frames via a gateway. The hook is called from
+              handlerReceive(), i.e. from task scheduler context in background operation.
+  \param[in]  Hook        hook function (context, ID, numData, data), or NULL to detach
+  \param[in]  Context     context pointer passed to hook
+*/
+void LIN_Master::attachFrameHook(LIN_frame_hook_t Hook, void *Context)
+{
+  // store hook and context
+  frameHook        = Hook;
+  frameHookContext = Context;
+
+} // LIN_Master::attachFrameHook()
+
+
+
+/**
+  \brief      Attach handler registry
+  \details    Attach a frame ID indexed handler registry, see LIN_registry.h. Then frames can be started by ID only,
+              and slave responses w/o explicit handler are dispatched via the registry. A registry may be shared.
+  \param[in]  Registry    handler registry, or NULL to detach
+*/
+void LIN_Master::attachRegistry(LIN_Registry *Registry)
+{
+  // store registry
+  registry = Registry;
+
+} // LIN_Master::attachRegistry()
+
+
+
+/**
+  \brief      Get attached handler registry
+  \details    Get handler registry attached via attachRegistry().
+  \return     handler registry, or NULL if none is attached
+*/
+LIN_Registry *LIN_Master::getRegistry(void)
+{
+  return registry;
+
+} // LIN_Master::getRegistry()
+
+
+
+/**
+  \brief      Attach E2E protection
+  \details    Attach E2E protection, see LIN_e2e.h. Then protected master requests get alive counter and CRC inserted,
+              and protected slave responses are verified before dispatch. Frames with other IDs are not affected.
+  \param[in]  E2E         E2E protection, or NULL to detach
+*/
+void LIN_Master::attachE2E(LIN_E2E *E2E)
+{
+  // store E2E protection
+  e2e = E2E;
+
+} // LIN_Master::attachE2E()
+
+
+
+/**
+  \brief      Set reception handler wrapper
+  \details    Replace the default wrapper for the reception handler, e.g. by a wrapper which calls
+              handlerReceive() with an observer chain. To restore use default wrapper, e.g. LIN_master1_receive.
+  \param[in]  Wrapper     wrapper for reception handler
+*/
+void LIN_Master::setReceiveWrapper(void (*Wrapper)(void))
+{
+  // store wrapper for task scheduler and blocking operation
+  wrapperReceive = Wrapper;
+
+} // LIN_Master::setReceiveWrapper()
+
+
+
+/**
+  \brief      Handler for LIN master transmission
+  \details    Handler for LIN master transmission. Here the remainder of the frame after sync break is sent.
+*/
+void LIN_Master::handlerSend(void)
+{
+  LIN_TRACE_EVENT(LIN_TRACE_HANDLER_BEGIN, traceBus, 0);
+
+  // check state of state machine
+  if (state != LIN_STATE_BREAK)
+  {
+    // for printing error message, set debug level >=1
+    #if (LIN_DEBUG_LEVEL >= 1)
+      LIN_DEBUG_SERIAL.print(millis());
+      LIN_DEBUG_SERIAL.print("ms ");
       LIN_DEBUG_SERIAL.print(serialName);
-      LIN_DEBUG_SERIAL.println(".handlerSend(): received BREAK echo");
+      LIN_DEBUG_SERIAL.print(".handlerSend(): state != LIN_STATE_BREAK (is ");
+      LIN_DEBUG_SERIAL.print(state);
+      LIN_DEBUG_SERIAL.println(")");
     #endif
+    LIN_atomicOr(error, LIN_ERROR_STATE);
+    publishResult(LIN_ERROR_STATE);
+    breakSent = false;
+    state = LIN_STATE_IDLE;
+    memset(bufRx, 0, lenRx);
+    LIN_TRACE_EVENT(LIN_TRACE_HANDLER_END, traceBus, 0);
+    return;
   }
 
 
-  // restore original baudrate after BREAK
-  #if defined(__AVR__)
-    *UCSRA |= (1<<U2X0);                               // on AVR restore "double baudrate"
-  #else
-    pSerial->begin(baudrate); while(!(*pSerial));      // else use built-in function
-  #endif
+  // echo-less operation -> only assert that BREAK has been sent
+  if (!echo)
+    pSerial->flush();
+
+  // check BREAK echo
+  else
+  {
+    // injected break may exceed the echo timeout -> wait until it has been sent
+    if (injectFaults & LIN_INJECT_BREAK)
+      pSerial->flush();
+
+    // wait until break received (with timeout) before changing baudrate
+    uint32_t tStart = micros();
+    while ((!(pSerial->available())) && ((micros() - tStart) < 500));
+
+
+    // assert no timeout
+    if (!(pSerial->available()))
+    {
+      // for printing error message, set debug level >=1
+      #if (LIN_DEBUG_LEVEL >= 1)
+        LIN_DEBUG_SERIAL.print(millis());
+        LIN_DEBUG_SERIAL.print("ms ");
+        LIN_DEBUG_SERIAL.print(serialName);
+        LIN_DEBUG_SERIAL.println(".handlerSend(): receive BREAK timeout");
+      #endif
+      recordBusFault(LIN_FAULT_NO_ECHO);
+      LIN_atomicOr(error, LIN_ERROR_TIMEOUT);
+      publishResult(LIN_ERROR_TIMEOUT);
+      breakSent = false;
+      state = LIN_STATE_IDLE;
+      memset(bufRx, 0, lenRx);
+      LIN_TRACE_EVENT(LIN_TRACE_HANDLER_END, traceBus, 0);
+      return;
+    }
+
+    // assert correct echo
+    bufRx[0] = pSerial->read();
+    if (bufRx[0] != 0x00)
+    {
+      // for printing error message, set debug level >=1
+      #if (LIN_DEBUG_LEVEL >= 1)
+        LIN_DEBUG_SERIAL.print(millis());
+        LIN_DEBUG_SERIAL.print("ms ");
+        LIN_DEBUG_SERIAL.print(serialName);
+        LIN_DEBUG_SERIAL.print(".handlerSend(): received BREAK != 0x00 (is ");
+        LIN_DEBUG_SERIAL.print(bufRx[0]);
+        LIN_DEBUG_SERIAL.println(")");
+      #endif
+      recordBusFault(LIN_FAULT_ECHO);
+      LIN_atomicOr(error, LIN_ERROR_ECHO);
+      publishResult(LIN_ERROR_ECHO);
+      breakSent = false;
+      state = LIN_STATE_IDLE;
+      memset(bufRx, 0, lenRx);
+      LIN_TRACE_EVENT(LIN_TRACE_HANDLER_END, traceBus, 0);
+      return;
+    }
+
+    // BREAK echo read successfully
+    else
+    {
+      #if (LIN_DEBUG_LEVEL >= 2)
+        LIN_DEBUG_SERIAL.print(millis());
+        LIN_DEBUG_SERIAL.print("ms ");
+        LIN_DEBUG_SERIAL.print(serialName);
+        LIN_DEBUG_SERIAL.println(".handlerSend(): received BREAK echo");
+      #endif
+    }
+  } // check BREAK echo
 
-  // write remainder of frame or header
-  pSerial->write(bufTx+1, lenTx-1);
+
+  // spec-limit timing: set (possibly offset) frame baudrate, extend delimiter and space bytes
+  if (timingActive)
+  {
+    pSerial->begin(((uint32_t) baudrate * (1000 + timing.baudOffset)) / 1000); while(!(*pSerial));
+    if (timing.delimiterUs != 0)
+      delayMicroseconds(timing.delimiterUs);
+    if (timing.interByteUs == 0)
+      pSerial->write(pTx+1, lenTx-1);
+    else
+    {
+      for (uint8_t i=1; i<lenTx; i++)
+      {
+        pSerial->write(pTx[i]);
+        pSerial->flush();
+        delayMicroseconds(timing.interByteUs);
+      }
+    }
+  } // spec-limit timing
+
+  // nominal timing
+  else
+  {
+    // restore original baudrate after BREAK
+    if (injectFaults & LIN_INJECT_BREAK)
+    {
+      pSerial->begin(baudrate); while(!(*pSerial));      // injected break length
+    }
+    else
+    {
+      #if defined(__AVR__)
+        *UCSRA |= (1<<U2X0);                             // on AVR restore "double baudrate"
+      #else
+        pSerial->begin(baudrate); while(!(*pSerial));    // else use built-in function
+      #endif
+    }
+
+    // write remainder of frame or header with injected delay
+    if ((injectFaults & LIN_INJECT_DELAY) && (injectEntry->delayPos >= 1) && (injectEntry->delayPos < lenTx))
+    {
+      pSerial->write(pTx+1, injectEntry->delayPos-1);
+      pSerial->flush();
+      delayMicroseconds(injectEntry->delayUs);
+      pSerial->write(pTx+injectEntry->delayPos, lenTx-injectEntry->delayPos);
+    }
+
+    // write remainder of frame or header
+    else
+      pSerial->write(pTx+1, lenTx-1);
+  }
+
+  // estimate end of transmission (10 bit per byte) for response window in echo-less operation
+  tTxComplete = micros() + ((uint32_t) (lenTx-1) * 10000000L) / baudrate;
 
   // set new state of LIN state machine
+  breakSent = false;
   state = LIN_STATE_FRAME;
+  LIN_TRACE_EVENT(LIN_TRACE_STATE, traceBus, LIN_STATE_FRAME);
 
-  // background operation
-  if (background)
+  // background operation. Bus scan probes are polled instead
+  if ((background) && (!probe))
   {
     // attach receive handler for reading frame echo or header echo + slave response
     Tasks_Add((Task) wrapperReceive, 0, durationFrame);
 
   } // background operation
 
+  LIN_TRACE_EVENT(LIN_TRACE_HANDLER_END, traceBus, 0);
+
 } // LIN_Master::handlerSend
 
 
 
 /**
-  \brief      Handler for LIN_master3 transmission
-  \details    Handler for LIN_master3 transmission. This wrapper is required for
-              task scheduler access to non-static member functions and class variables.
+  \brief      Handler for LIN master reception
+  \details    Handler for LIN master reception. Here the frame echo and slave response are received and checked.
 */
 void LIN_Master::handlerReceive(void)
+{
+  // process frame w/o observers
+  LIN_TRACE_EVENT(LIN_TRACE_HANDLER_BEGIN, traceBus, 1);
+  processReceive();
+  LIN_TRACE_EVENT(LIN_TRACE_HANDLER_END, traceBus, 1);
+
+} // LIN_Master::handlerReceive
+
+
+
+/**
+  \brief      Receive and check frame
+  \details    Receive and check frame echo and slave response, and call receive callback. Used by handlerReceive().
+  \return     error of this frame, or LIN_SUCCESS
+*/
+LIN_error_t LIN_Master::processReceive(void)
 {
   uint8_t   i;
 
@@ -494,20 +1517,47 @@ void LIN_Master::handlerReceive(void)
       LIN_DEBUG_SERIAL.print(state);
       LIN_DEBUG_SERIAL.println(")");
     #endif
-    error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_STATE);
+    LIN_atomicOr(error, LIN_ERROR_STATE);
+    publishResult(LIN_ERROR_STATE);
     state = LIN_STATE_IDLE;
     memset(bufRx, 0, lenRx);
-    return;
+    return LIN_ERROR_STATE;
   }
 
 
-  // wait until break received (with timeout) before changing baudrate
-  uint32_t tStart = micros();
-  while ((pSerial->available() != lenRx-1) && ((micros() - tStart) < 500));
+  // number of bytes to receive: frame echo (-1 because sync break already read), or only slave response w/o echo
+  uint8_t   numRx = lenRx-1;
+  uint32_t  tDeadline = micros() + 500;
+  if (!echo)
+  {
+    // master request -> nothing to receive, just wait until frame has been sent
+    if (frameType == LIN_MASTER_REQUEST)
+    {
+      pSerial->flush();
+      numRx = 0;
+    }
 
+    // slave response -> response window (1.4*nominal) starts after header has been sent
+    else
+    {
+      numRx = lenRx-3;
+      tDeadline = tTxComplete + ((uint32_t) numRx * 14000000L) / baudrate;
+    }
+  }
 
-  // check if data was received (-1 because sync break already read)
-  if (pSerial->available() != lenRx-1)
+  // spec-limit timing -> extend deadline by stretched delimiter and byte spaces
+  if (timingActive)
+    tDeadline += timing.delimiterUs + (uint32_t) timing.interByteUs * (lenTx-1);
+
+
+  // wait until frame received (with timeout). Time of reception is only known in blocking operation. In background
+  // operation the bytes are already buffered when the receive handler is called -> don't measure, see LIN_result_t
+  while ((pSerial->available() != numRx) && ((int32_t) (tDeadline - micros()) > 0));
+  tDone = (background) ? tFrameStart : micros();
+
+
+  // check if data was received
+  if (pSerial->available() != numRx)
   {
     // for printing error message, set debug level >=1
     #if (LIN_DEBUG_LEVEL >= 1)
@@ -528,16 +1578,30 @@ void LIN_Master::handlerReceive(void)
       }
       */
     #endif
-    error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_TIMEOUT);
+
+    // incomplete header echo -> bus fault (no edges after BREAK indicates dominant bus). Else slave didn't respond
+    if (echo)
+    {
+      uint8_t  numEcho = pSerial->available();
+      if (numEcho < lenTx-1)
+        recordBusFault((numEcho == 0) ? LIN_FAULT_DOMINANT : LIN_FAULT_ECHO);
+      else
+        recordBusFault(LIN_FAULT_NONE);
+    }
+
+    LIN_atomicOr(error, LIN_ERROR_TIMEOUT);
+    publishResult(LIN_ERROR_TIMEOUT);
     state = LIN_STATE_IDLE;
     memset(bufRx, 0, lenRx);
     flagTxComplete = true;
-    return;
+    return LIN_ERROR_TIMEOUT;
   }
 
 
-  // copy received bytes to LIN buffer
-  for (i=1; i<lenRx; i++)
+  // copy received bytes to LIN buffer. W/o echo use sent bytes instead
+  if (!echo)
+    memcpy(bufRx, pTx, lenTx);
+  for (i=lenRx-numRx; i<lenRx; i++)
     bufRx[i] = pSerial->read();
 
 
@@ -545,7 +1609,7 @@ void LIN_Master::handlerReceive(void)
   if (frameType == LIN_MASTER_REQUEST)
   {
     // check if sent and received data match
-    if (memcmp(bufRx, bufTx, lenTx) != 0)
+    if (memcmp(bufRx, pTx, lenTx) != 0)
     {
       // for printing error message, set debug level >=1
       #if (LIN_DEBUG_LEVEL >= 1)
@@ -559,15 +1623,17 @@ void LIN_Master::handlerReceive(void)
           LIN_DEBUG_SERIAL.print(i);
           LIN_DEBUG_SERIAL.print(": 0x"); LIN_DEBUG_SERIAL.print((uint8_t) (bufRx[i]), HEX);
           LIN_DEBUG_SERIAL.print(" vs. ");
-          LIN_DEBUG_SERIAL.print(" 0x"); LIN_DEBUG_SERIAL.print((uint8_t) (bufTx[i]), HEX);
+          LIN_DEBUG_SERIAL.print(" 0x"); LIN_DEBUG_SERIAL.print((uint8_t) (pTx[i]), HEX);
           LIN_DEBUG_SERIAL.println();
         }
       #endif
-      error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_ECHO);
+      recordBusFault(((bufRx[1] == 0x00) && (bufRx[2] == 0x00)) ? LIN_FAULT_DOMINANT : LIN_FAULT_ECHO);
+      LIN_atomicOr(error, LIN_ERROR_ECHO);
+      publishResult(LIN_ERROR_ECHO);
       state = LIN_STATE_IDLE;
       memset(bufRx, 0, lenRx);
       flagTxComplete = true;
-      return;
+      return LIN_ERROR_ECHO;
     } // frame echo mismatch
 
     // frame echo read successfully
@@ -580,8 +1646,19 @@ void LIN_Master::handlerReceive(void)
         LIN_DEBUG_SERIAL.println(".handlerReceive: received frame echo");
       #endif
 
+      // bus is ok
+      recordBusFault(LIN_FAULT_NONE);
+
       // indicate that data transmission is complete
       flagTxComplete = true;
+
+      // pass sent frame to optional hook. Only data bytes (- BREAK - SYNC - ID - CHK)
+      if (frameHook != NULL)
+      {
+        LIN_TRACE_EVENT(LIN_TRACE_CALLBACK_BEGIN, traceBus, 1);
+        frameHook(frameHookContext, pTx[2] & 0x3F, lenTx-4, pTx+3);
+        LIN_TRACE_EVENT(LIN_TRACE_CALLBACK_END, traceBus, 1);
+      }
     }
 
   } // LIN_MASTER_REQUEST
@@ -591,7 +1668,7 @@ void LIN_Master::handlerReceive(void)
   else
   {
     // check if sent and received frame headers (BREAK+SYNC+ID) match
-    if (memcmp(bufRx, bufTx, 3) != 0) {
+    if (memcmp(bufRx, pTx, 3) != 0) {
       // for printing error message, set debug level >=1
       #if (LIN_DEBUG_LEVEL >= 1)
         LIN_DEBUG_SERIAL.print(millis());
@@ -604,17 +1681,22 @@ void LIN_Master::handlerReceive(void)
           LIN_DEBUG_SERIAL.print(i);
           LIN_DEBUG_SERIAL.print(": 0x"); LIN_DEBUG_SERIAL.print((uint8_t) (bufRx[i]), HEX);
           LIN_DEBUG_SERIAL.print(" vs. ");
-          LIN_DEBUG_SERIAL.print(" 0x"); LIN_DEBUG_SERIAL.print((uint8_t) (bufTx[i]), HEX);
+          LIN_DEBUG_SERIAL.print(" 0x"); LIN_DEBUG_SERIAL.print((uint8_t) (pTx[i]), HEX);
           LIN_DEBUG_SERIAL.println();
         }
       #endif
-      error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_ECHO);
+      recordBusFault(((bufRx[1] == 0x00) && (bufRx[2] == 0x00)) ? LIN_FAULT_DOMINANT : LIN_FAULT_ECHO);
+      LIN_atomicOr(error, LIN_ERROR_ECHO);
+      publishResult(LIN_ERROR_ECHO);
       state = LIN_STATE_IDLE;
       memset(bufRx, 0, lenRx);
       flagRxComplete = true;
-      return;
+      return LIN_ERROR_ECHO;
     } // header echo mismatch
 
+    // header echo ok -> bus is ok
+    recordBusFault(LIN_FAULT_NONE);
+
 
     // assert checksum
     uint8_t  id      = bufRx[2];                      // frame ID
@@ -633,15 +1715,51 @@ void LIN_Master::handlerReceive(void)
         LIN_DEBUG_SERIAL.print(chk, HEX); LIN_DEBUG_SERIAL.print(" vs. "); LIN_DEBUG_SERIAL.print(chk_calc, HEX);
         LIN_DEBUG_SERIAL.println(")");
       #endif
-      error = (LIN_error_t)((uint8_t) error | (uint8_t) LIN_ERROR_CHK);
+      LIN_atomicOr(error, LIN_ERROR_CHK);
+      publishResult(LIN_ERROR_CHK);
       state = LIN_STATE_IDLE;
       memset(bufRx, 0, lenRx);
       flagRxComplete = true;
-      return;
+      return LIN_ERROR_CHK;
     } // checksum error
 
-    // use callback function to handle received data. Only data bytes (- BREAK - SYNC - ID - CHK)
-    rx_handler(lenRx-4, bufRx+3);
+    // assert optional E2E counter and CRC
+    if ((e2e != NULL) && (e2e->check(id, numData, data) != LIN_SUCCESS))
+    {
+      // for printing error message, set debug level >=1
+      #if (LIN_DEBUG_LEVEL >= 1)
+        LIN_DEBUG_SERIAL.print(millis());
+        LIN_DEBUG_SERIAL.print("ms ");
+        LIN_DEBUG_SERIAL.print(serialName);
+        LIN_DEBUG_SERIAL.println(".handlerReceive: E2E error");
+      #endif
+      LIN_atomicOr(error, LIN_ERROR_E2E);
+      publishResult(LIN_ERROR_E2E);
+      state = LIN_STATE_IDLE;
+      memset(bufRx, 0, lenRx);
+      flagRxComplete = true;
+      return LIN_ERROR_E2E;
+    } // E2E error
+
+    // copy to buffer or use callback function to handle received data. Only data bytes (- BREAK - SYNC - ID - CHK)
+    LIN_TRACE_EVENT(LIN_TRACE_CALLBACK_BEGIN, traceBus, 0);
+    if (dataPtr != NULL)
+      memcpy(dataPtr, bufRx+3, lenRx-4);
+    else if (rx_callback != NULL)
+      rx_callback(rx_context, lenRx-4, bufRx+3);
+    else if (rx_handler != NULL)
+      rx_handler(lenRx-4, bufRx+3);
+    else if (registry != NULL)
+      registry->dispatch(bufRx[2], lenRx-4, bufRx+3);
+    LIN_TRACE_EVENT(LIN_TRACE_CALLBACK_END, traceBus, 0);
+
+    // pass received frame to optional hook
+    if (frameHook != NULL)
+    {
+      LIN_TRACE_EVENT(LIN_TRACE_CALLBACK_BEGIN, traceBus, 1);
+      frameHook(frameHookContext, id & 0x3F, numData, data);
+      LIN_TRACE_EVENT(LIN_TRACE_CALLBACK_END, traceBus, 1);
+    }
 
     // indicate that data reception is complete
     flagRxComplete = true;
@@ -650,20 +1768,9 @@ void LIN_Master::handlerReceive(void)
 
 
   // reset state of LIN state machine
+  publishResult(LIN_SUCCESS);
   state = LIN_STATE_IDLE;
 
-} // LIN_Master::handlerReceive
-
-
-
-/**
-  \brief      Receive handler to copy data to buffer
-  \details    Dummy receive handler for receiveSlaveResponse() to copy data to a specified buffer.
-              array pointer must be stored in dataPtr before calling
-*/
-void LIN_Master::defaultCallback(uint8_t numData, uint8_t *data)
-{
-  // copy received data to user buffer
-  memcpy(dataPtr, data, numData);
+  return LIN_SUCCESS;
 
-} // LIN_Master::defaultCallback
+} // LIN_Master::processReceive
@@ -21,6 +21,11 @@
 
 #define LIN_DEBUG_SERIAL   Serial       //!< Serial interface used for debug output
 #define LIN_DEBUG_LEVEL    0            //!< Debug level (0=no output, 1=error msg, 2=sent/received bytes)
+#define LIN_FAULT_THRESHOLD 3           //!< consecutive bus faults until fault state
+#define LIN_FAULT_PROBE    100          //!< period of probe frames in bus fault state [ms]
+#define LIN_PROBE_SPACE    40           //!< bus scan: max. time from header until response [Tbit]
+#define LIN_PROBE_GAP      20           //!< bus scan: max. time between response bytes [Tbit]
+#define LIN_TIMING_OFFSET  200          //!< spec-limit timing: max. deviation of frame baudrate [0.1%]
 
 
 /*-----------------------------------------------------------------------------
@@ -36,6 +41,8 @@
 
 // include required libs
 #include "Arduino.h"
+#include "LIN_atomic.h"
+#include "LIN_trace.h"
 #include "Tasks.h"
 
 
@@ -70,6 +77,9 @@ typedef enum {
     LIN_ERROR_ECHO    = 0x02,       //!< error reading LIN echo
     LIN_ERROR_TIMEOUT = 0x04,       //!< LIN receive timeout
     LIN_ERROR_CHK     = 0x08,       //!< LIN checksum error
+    LIN_ERROR_OVERRUN = 0x10,       //!< frame exceeded its slot and was aborted
+    LIN_ERROR_FAULT   = 0x20,       //!< frame skipped due to bus fault
+    LIN_ERROR_E2E     = 0x40,       //!< E2E counter or CRC error, see LIN_e2e.h
     LIN_ERROR_MISC    = 0x80        //!< misc error, should not occur
 } LIN_error_t;
 
@@ -85,21 +95,131 @@ typedef enum {
 } LIN_status_t;
 
 
+/**
+    \brief bus fault detected from LIN echo
+*/
+typedef enum {
+    LIN_FAULT_NONE     = 0,         //!< no bus fault
+    LIN_FAULT_NO_ECHO  = 1,         //!< no BREAK echo, e.g. open bus or short to VBAT
+    LIN_FAULT_DOMINANT = 2,         //!< Rx permanently dominant, e.g. short to GND
+    LIN_FAULT_ECHO     = 3          //!< corrupted echo
+} LIN_fault_t;
+
+
+/**
+    \brief checksum model detected by bus scan
+*/
+typedef enum {
+    LIN_CHK_NONE      = 0,          //!< no response
+    LIN_CHK_CLASSIC   = 1,          //!< classic checksum (LIN1.x or diagnostic frame)
+    LIN_CHK_ENHANCED  = 2,          //!< enhanced checksum (LIN2.x)
+    LIN_CHK_INVALID   = 3           //!< response with invalid checksum, e.g. collision
+} LIN_checksum_t;
+
+
+/**
+    \brief result of last frame, see LIN_Master::getResult()
+*/
+typedef struct {
+    uint8_t           id;           //!< frame ID (unprotected)
+    LIN_frame_t       type;         //!< LIN_MASTER_REQUEST or LIN_SLAVE_RESPONSE
+    uint8_t           numData;      //!< number of data bytes
+    uint8_t           data[8];      //!< data bytes. Only valid if error == LIN_SUCCESS
+    LIN_error_t       error;        //!< error of this frame, or LIN_SUCCESS
+    uint16_t          timeFrame;    //!< duration from BREAK until frame received [us]. 0 if aborted before reception or in background operation
+    uint16_t          timeResponse; //!< duration from end of header until slave response received [us]. 0 for master request or in background operation
+} LIN_result_t;
+
+
+/**
+    \brief result of bus scan probe, see LIN_Master::pollProbe()
+*/
+typedef struct {
+    uint8_t           id;           //!< frame ID (unprotected)
+    uint8_t           numData;      //!< detected number of data bytes
+    uint8_t           data[8];      //!< received data bytes
+    LIN_checksum_t    model;        //!< detected checksum model
+    LIN_error_t       error;        //!< error of probe, e.g. LIN_ERROR_ECHO
+} LIN_probe_t;
+
+
+/**
+    \brief timing parameters for spec-limit stress mode
+*/
+typedef struct {
+    uint8_t           breakBits;    //!< break length [Tbit] (>=10, nominal 18). 0 = nominal
+    uint16_t          delimiterUs;  //!< additional delay between break delimiter and sync field [us]
+    uint16_t          interByteUs;  //!< additional space between bytes after break [us]
+    int16_t           baudOffset;   //!< deviation of frame baudrate from nominal [0.1%], max. +/-LIN_TIMING_OFFSET
+} LIN_timing_t;
+
+
+/**
+    \brief fault injection types, see LIN_Master::setInjection(). May be combined
+*/
+typedef enum {
+    LIN_INJECT_NONE     = 0x00,     //!< no fault, i.e. clean frame
+    LIN_INJECT_CHK      = 0x01,     //!< inverted checksum (master request only)
+    LIN_INJECT_PARITY   = 0x02,     //!< wrong PID parity
+    LIN_INJECT_BREAK    = 0x04,     //!< break length breakBits instead of nominal
+    LIN_INJECT_SYNC     = 0x08,     //!< sync byte sync instead of 0x55
+    LIN_INJECT_TRUNCATE = 0x10,     //!< send only numBytes bytes after break
+    LIN_INJECT_DELAY    = 0x20      //!< extra delay delayUs before byte delayPos after break (1=SYNC)
+} LIN_inject_type_t;
+
+
+/**
+    \brief entry of fault injection schedule
+*/
+typedef struct {
+    uint8_t           id;           //!< frame ID (unprotected) the entry applies to, 0xFF = any frame
+    uint8_t           faults;       //!< injected faults, see LIN_inject_type_t
+    uint8_t           breakBits;    //!< break length for LIN_INJECT_BREAK [Tbit] (>=10, else ignored)
+    uint8_t           sync;         //!< sync byte for LIN_INJECT_SYNC
+    uint8_t           numBytes;     //!< bytes after break for LIN_INJECT_TRUNCATE (min. SYNC+ID)
+    uint8_t           delayPos;     //!< position of delay for LIN_INJECT_DELAY (1=SYNC, 2=PID, 3=first data byte)
+    uint16_t          delayUs;      //!< delay for LIN_INJECT_DELAY [us]
+} LIN_inject_t;
+
+
 /**
     \brief typedef for data decoder to hadle received data
 */
 typedef void (*decoder_t)(uint8_t,uint8_t*);
 
 
+/**
+    \brief typedef for receive callback with user context (context, numData, data)
+*/
+typedef void (*LIN_callback_t)(void*,uint8_t,uint8_t*);
+
+
+/**
+    \brief typedef for frame hook, called after each successful frame with (context, ID, numData, data)
+*/
+typedef void (*LIN_frame_hook_t)(void*,uint8_t,uint8_t,uint8_t*);
+
+
 
 /*-----------------------------------------------------------------------------
   GLOBAL CLASS
 -----------------------------------------------------------------------------*/
 
+// signal store for master requests, see LIN_frame.h
+class LIN_Frame;
+
+// handler registry, see LIN_registry.h
+class LIN_Registry;
+class LIN_E2E;
+
 /**
   \brief  LIN master node base class
 
   \details LIN master node base class. From this class the actual LIN classes for a Serialx are derived.
+           Concurrency: frame starts claim the state machine atomically, and errors are latched atomically.
+           sendMasterRequest(), receiveSlaveResponse(), getState(), getError(), clearError() and getResult()
+           may be called from loop() and from task scheduler callbacks without masking interrupts. Read
+           received data via getResult() instead of the receive buffer for a consistent copy.
 */
 class LIN_Master
 {
@@ -112,7 +232,6 @@ class LIN_Master
     #endif
     void              (*wrapperSend)(void);                                   //!< wrapper for transmission handler (for task scheduler)
     void              (*wrapperReceive)(void);                                //!< wrapper for reception handler (for task scheduler)
-    void              (*wrapperDefaultCallback)(uint8_t, uint8_t*);           //!< wrapper for default receive callback function
     #if (LIN_DEBUG_LEVEL != 0)
       char            serialName[20];                                         //!< for debug store class name for convenience
     #endif
@@ -122,37 +241,142 @@ class LIN_Master
     uint8_t           durationBreak;                                          //!< duration of sync break [ms]
     LIN_frame_t       frameType;                                              //!< LIN frame type
     uint8_t           bufTx[12];                                              //!< send buffer incl. BREAK, SYNC, DATA and CHK (max. 12B)
+    uint8_t           *pTx;                                                   //!< frame to send, bufTx or assembled LIN_Frame
     uint8_t           lenTx;                                                  //!< send buffer length (max. 12)
     uint8_t           bufRx[12];                                              //!< receive buffer incl. SYNC, DATA and CHK (max. 11B)
     uint8_t           lenRx;                                                  //!< receive buffer length (max. 12)
     uint8_t           durationFrame;                                          //!< duration of frame w/o BREAK [ms]
-    LIN_status_t      state;                                                  //!< status of LIN state machine
-    void              (*rx_handler)(uint8_t, uint8_t*);                       //!< handler to decode slave response (for receiveFrame())
-    uint8_t           *dataPtr;                                               //!< pointer to data buffer in LIN_master3_copy()
+    volatile LIN_status_t state;                                              //!< status of LIN state machine
+    void              (*rx_handler)(uint8_t, uint8_t*);                       //!< handler to decode slave response, or NULL
+    LIN_callback_t    rx_callback;                                            //!< handler with context to decode slave response, or NULL
+    void              *rx_context;                                            //!< context pointer passed to rx_callback
+    uint8_t           *dataPtr;                                               //!< buffer to copy slave response to, or NULL
+    LIN_frame_hook_t  frameHook;                                              //!< optional hook called after each successful frame (e.g. gateway)
+    void              *frameHookContext;                                      //!< context pointer passed to frameHook
+    LIN_Registry      *registry;                                              //!< optional frame ID indexed handler registry
+    LIN_E2E           *e2e;                                                   //!< optional E2E protection of frames
+    bool              probe;                                                  //!< bus scan probe ongoing, see startProbe()
+    uint8_t           numProbeRx;                                             //!< bytes received by probe at last poll
+    uint32_t          tProbeRx;                                               //!< time of last byte received by probe [us]
+    const LIN_inject_t *injectTable;                                          //!< fault injection schedule, or NULL
+    uint8_t           numInject;                                              //!< number of entries in fault injection schedule
+    uint8_t           idxInject;                                              //!< next entry of fault injection schedule
+    bool              injectRepeat;                                           //!< restart fault injection schedule after last entry
+    uint8_t           injectFaults;                                           //!< faults injected into current frame
+    const LIN_inject_t *injectEntry;                                          //!< fault injection entry of current frame
+    LIN_timing_t      timing;                                                 //!< spec-limit timing parameters
+    bool              timingActive;                                           //!< use spec-limit timing instead of nominal timing
+    bool              echo;                                                   //!< read back and check LIN echo
+    uint32_t          tTxComplete;                                            //!< estimated end of transmission [us]
+    uint32_t          tFrameStart;                                            //!< start of BREAK [us]
+    uint32_t          tDone;                                                  //!< end of frame reception [us]
+    bool              slotGuard;                                              //!< abort overrunning frame instead of rejecting new frame
+    volatile bool     breakSent;                                              //!< break of current frame was sent, i.e. frame is on the bus
+    uint8_t           countFault;                                             //!< number of consecutive bus faults
+    uint32_t          tProbe;                                                 //!< time of last probe frame in bus fault state [ms]
+    volatile uint8_t  seqResult;                                              //!< sequence counter of result. Odd while result is written
+    LIN_result_t      result;                                                 //!< result of last frame, see getResult()
+    #if (LIN_TRACE != 0)
+      uint8_t         traceBus;                                               //!< index of this master in execution trace
+    #endif
 
     // internal methods
     uint8_t           protectID(uint8_t id);                                  //!< calculate protected LIN ID
     uint8_t           checksum(uint8_t id, uint8_t numData, uint8_t *data);   //!< calculate frame checksum
+    uint8_t           checksum(uint8_t id, uint8_t numData, uint8_t *data, LIN_version_t Version);  //!< calculate frame checksum for LIN version
+    void              injectFault(void);                                      //!< apply next fault injection entry to frame
+    void              sendBreak(void);                                        //!< clear receive buffer and send sync break
+    void              abortFrame(void);                                       //!< abort ongoing frame after slot overrun
+    void              recordBusFault(LIN_fault_t Fault);                      //!< record result of echo check
+    bool              checkBusFault(void);                                    //!< check if frame is skipped due to bus fault
+    void              publishResult(LIN_error_t Error);                       //!< publish result of finished frame
+    LIN_error_t       prepareMasterRequest(void);                             //!< check state before master request
+    LIN_error_t       startMasterRequest(void);                               //!< start master request assembled in pTx
+    LIN_error_t       startSlaveResponse(uint8_t id, uint8_t numData, uint8_t *Data, LIN_callback_t Callback, void *Context, decoder_t Handler, bool Probe=false);  //!< start slave response frame
+    LIN_error_t       processReceive(void);                                   //!< receive and check frame, call receive callback
+
+    /// thunk to call functor from receive callback with context
+    template <class F> static void callFunctor(void *Functor, uint8_t numData, uint8_t *data)
+    {
+      (*((F*) Functor))(numData, data);
+    }
 
 
   public:
 
     // public variables
-    bool              flagTxComplete;                                         //!< flag to indicate that data transmission is complete. Must be cleared manually
-    bool              flagRxComplete;                                         //!< flag to indicate that data reception is complete. Must be cleared manually
-    LIN_error_t       error;                                                  //!< error state. Is latched until cleared
+    volatile bool     flagTxComplete;                                         //!< flag to indicate that data transmission is complete. Must be cleared manually
+    volatile bool     flagRxComplete;                                         //!< flag to indicate that data reception is complete. Must be cleared manually
+    volatile LIN_error_t error;                                               //!< error state. Is latched until cleared
+    uint16_t          numOverrun;                                             //!< number of frames aborted by slot guard
+    LIN_fault_t       fault;                                                  //!< detected bus fault. Frames are skipped except for periodic probes
 
     // public methods
     void              begin(uint16_t Baudrate, LIN_version_t Version, bool Background);  //!< setup UART and LIN framework
     void              end(void);                                              //!< end UART communication    void              end(void);                                                         //!< end UART communication
     LIN_error_t       sendMasterRequest(uint8_t id, uint8_t numData, uint8_t *data);     //!< send a master request frame
+    LIN_error_t       sendMasterRequest(LIN_Frame &Frame);                               //!< send a master request frame from signal store
+    LIN_error_t       sendMasterRequest(uint8_t id);                                     //!< send a master request frame from registry
+    LIN_error_t       receiveSlaveResponse(uint8_t id);                                  //!< receive a slave response frame via registry
     LIN_error_t       receiveSlaveResponse(uint8_t id, uint8_t numData, void (*Rx_handler)(uint8_t, uint8_t*));  //!< receive a slave response frame with callback function
+    LIN_error_t       receiveSlaveResponse(uint8_t id, uint8_t numData, LIN_callback_t Callback, void *Context);  //!< receive a slave response frame with context callback function
     LIN_error_t       receiveSlaveResponse(uint8_t id, uint8_t numData, uint8_t *data);  //!< receive a slave response frame and copy to buffer
 
+    /**
+      \brief     Receive slave response frame with functor
+      \details   Receive a slave response and handle data with a functor or lambda with signature (numData, data).
+                 The functor is called via an inlined thunk, i.e. captures replace global variables.
+                 The functor must remain valid until reception is complete.
+      \param[in] id        frame ID (protection optional)
+      \param[in] numData   number of data bytes (0..8)
+      \param[in] Functor   functor or lambda to handle received data
+    */
+    template <class F> LIN_error_t receiveSlaveResponse(uint8_t id, uint8_t numData, F &Functor)
+    {
+      return startSlaveResponse(id, numData, NULL, callFunctor<F>, (void*) &Functor, NULL);
+    }
+    LIN_status_t      getState(void);                                         //!< get state of LIN state machine
+    LIN_error_t       startProbe(uint8_t id);                                 //!< start bus scan probe of a frame ID
+    bool              pollProbe(LIN_probe_t &Result);                         //!< poll bus scan probe. Return true if finished
+    LIN_error_t       getError(void);                                         //!< get latched errors
+    LIN_error_t       clearError(void);                                       //!< get and clear latched errors atomically
+    uint8_t           getResult(LIN_result_t &Result);                        //!< get consistent copy of last frame result
+    uint32_t          frameDurationMax(uint8_t numData);                      //!< worst-case duration of a frame [us]
+    void              setSlotGuard(bool Guard);                               //!< enable or disable abort of overrunning frames
+    void              setEcho(bool Echo);                                     //!< enable or disable reading back LIN echo
+    void              setTiming(const LIN_timing_t *Timing);                  //!< set spec-limit timing. Use NULL for nominal timing
+    void              setInjection(const LIN_inject_t *Table, uint8_t Num, bool Repeat=false);  //!< set fault injection schedule. Use NULL to stop
+    uint8_t           getInjected(void);                                      //!< get faults injected into last frame
+    uint32_t          getHeaderEnd(void);                                     //!< get end of header of current frame [us]
+    void              attachFrameHook(LIN_frame_hook_t Hook, void *Context);  //!< attach hook for successful frames. Use NULL to detach
+    void              attachRegistry(LIN_Registry *Registry);                 //!< attach handler registry. Use NULL to detach
+    LIN_Registry      *getRegistry(void);                                     //!< get attached handler registry, or NULL
+    void              attachE2E(LIN_E2E *E2E);                                //!< attach E2E protection. Use NULL to detach
+    void              setReceiveWrapper(void (*Wrapper)(void));               //!< set reception handler wrapper, e.g. with observers
+
     /// LIN master receive handler for task scheduler
     void              handlerSend(void);                                      //!< send handler for task scheduler
-    void              handlerReceive(void);                                   //!< send handler for task scheduler
-    void              defaultCallback(uint8_t numData, uint8_t *data);        //!< receive callback function to copy data to buffer
+    void              handlerReceive(void);                                   //!< receive handler for task scheduler
+
+    /**
+      \brief     Receive handler with compile-time observers
+      \details   Receive handler which calls the observer (chain) at handler start, frame completion and error,
+                 see LIN_observer.h. Call from a custom wrapper attached via setReceiveWrapper().
+                 Observers are resolved at compile time, i.e. unused hooks cost nothing.
+      \param[in] Obs   observer or observer chain
+    */
+    template <class Observer> void handlerReceive(Observer &Obs)
+    {
+      LIN_TRACE_EVENT(LIN_TRACE_HANDLER_BEGIN, traceBus, 1);
+      Obs.onReceiveStart(*this);
+      LIN_error_t  res = processReceive();
+      if (res == LIN_SUCCESS)
+        Obs.onFrameComplete(*this, bufRx[2] & 0x3F, lenRx-4, bufRx+3);
+      else
+        Obs.onFrameError(*this, res);
+      LIN_TRACE_EVENT(LIN_TRACE_HANDLER_END, traceBus, 1);
+    }
+
 
 };
 
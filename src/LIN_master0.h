@@ -53,9 +53,6 @@ void LIN_master0_send(void);
 /// Wrapper for LIN_master0 reception handler
 void LIN_master0_receive(void);
 
-/// Wrapper for LIN_master0 default receive callback function
-void LIN_master0_copy(uint8_t numData, uint8_t *data);
-
 #endif // HAVE_HWSERIAL0 || SERIAL_PORT_HARDWARE
 
 /*-----------------------------------------------------------------------------
@@ -35,7 +35,6 @@ LIN_Master_1::LIN_Master_1()
   // store callback functions for task scheduler
   wrapperSend            = LIN_master1_send;
   wrapperReceive         = LIN_master1_receive;
-  wrapperDefaultCallback = LIN_master1_copy;
 
   // for debug store class name for convenience
   #if (LIN_DEBUG_LEVEL != 0)
@@ -72,18 +71,4 @@ void LIN_master1_receive(void)
 
 } // LIN_master1_receive
 
-
-
-/**
-  \brief      Wrapper for LIN_master1 default receive callback function
-  \details    Wrapper for LIN_master1 default receive callback function for receiveSlaveResponse().
-              Just copies data to a specified buffer.
-*/
-void LIN_master1_copy(uint8_t numData, uint8_t *data)
-{
-  // copy received data to user buffer
-  LIN_master1.defaultCallback(numData, data);
-
-} // LIN_master1_copy
-
 #endif // HAVE_HWSERIAL1 || SERIAL_PORT_HARDWARE1
@@ -53,9 +53,6 @@ void LIN_master1_send(void);
 /// Wrapper for LIN_master1 reception handler
 void LIN_master1_receive(void);
 
-/// Wrapper for LIN_master1 default receive callback function
-void LIN_master1_copy(uint8_t numData, uint8_t *data);
-
 #endif // HAVE_HWSERIAL1 || SERIAL_PORT_HARDWARE1
 
 /*-----------------------------------------------------------------------------
@@ -35,7 +35,6 @@ LIN_Master_2::LIN_Master_2()
   // store callback functions for task scheduler
   wrapperSend            = LIN_master2_send;
   wrapperReceive         = LIN_master2_receive;
-  wrapperDefaultCallback = LIN_master2_copy;
 
   // for debug store class name for convenience
   #if (LIN_DEBUG_LEVEL != 0)
@@ -72,18 +71,4 @@ void LIN_master2_receive(void)
 
 } // LIN_master2_receive
 
-
-
-/**
-  \brief      Wrapper for LIN_master2 default receive callback function
-  \details    Wrapper for LIN_master2 default receive callback function for receiveSlaveResponse().
-              Just copies data to a specified buffer.
-*/
-void LIN_master2_copy(uint8_t numData, uint8_t *data)
-{
-  // copy received data to user buffer
-  LIN_master2.defaultCallback(numData, data);
-
-} // LIN_master2_copy
-
 #endif // HAVE_HWSERIAL2 || SERIAL_PORT_HARDWARE2
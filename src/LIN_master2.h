@@ -53,9 +53,6 @@ void LIN_master2_send(void);
 /// Wrapper for LIN_master2 reception handler
 void LIN_master2_receive(void);
 
-/// Wrapper for LIN_master2 default receive callback function
-void LIN_master2_copy(uint8_t numData, uint8_t *data);
-
 #endif // HAVE_HWSERIAL2 || SERIAL_PORT_HARDWARE2
 
 /*-----------------------------------------------------------------------------
@@ -53,9 +53,6 @@ void LIN_master3_send(void);
 /// Wrapper for LIN_master3 reception handler
 void LIN_master3_receive(void);
 
-/// Wrapper for LIN_master3 default receive callback function
-void LIN_master3_copy(uint8_t numData, uint8_t *data);
-
 #endif // HAVE_HWSERIAL3 || SERIAL_PORT_HARDWARE3
 
 /*-----------------------------------------------------------------------------
@@ -0,0 +1,452 @@
+/**
+  \file     LIN_observer.h
+  \brief    Compile-time frame observers for LIN master emulation
+  \details  This library provides frame observers which are called by LIN_Master::handlerReceive() at handler
+            start, frame completion and error. Observers are composed at compile time via LIN_Observer_Chain,
+            i.e. there is no runtime dispatch and unused hooks vanish from the binary.
+            Usage:
+              LIN_Observer_Chain<LIN_Observer_Stats&, LIN_Gateway&> observers(stats, gateway);
+              void LIN_receive1(void) { LIN_master1.handlerReceive(observers); }
+              LIN_master1.setReceiveWrapper(LIN_receive1);
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_OBSERVER_H_
+#define _LIN_OBSERVER_H_
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+#include "LIN_histogram.h"
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASSES
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Observer base class
+
+  \details Observer with empty hooks. Derive custom observers from this class and hide only the required hooks.
+           Hooks are not virtual on purpose, they are resolved at compile time.
+*/
+class LIN_Observer
+{
+  public:
+
+    /// called at start of receive handler, i.e. after the frame has been sent
+    inline void onReceiveStart(LIN_Master&) { }
+
+    /// called after successful frame with data bytes
+    inline void onFrameComplete(LIN_Master&, uint8_t, uint8_t, uint8_t*) { }
+
+    /// called after failed frame with error of this frame
+    inline void onFrameError(LIN_Master&, LIN_error_t) { }
+};
+
+
+
+/**
+  \brief  Chain of two observers
+
+  \details Chain of two observers which are called in order. Types may be references to existing observers.
+           For more observers nest chains, e.g. LIN_Observer_Chain<A, LIN_Observer_Chain<B, C> >.
+*/
+template <class A, class B> class LIN_Observer_Chain
+{
+  public:
+
+    // public variables
+    A     first;                                                            //!< first observer
+    B     second;                                                           //!< second observer
+
+    /// class constructor for default constructible observers
+    LIN_Observer_Chain() : first(), second() { }
+
+    /// class constructor with observer instances, e.g. for references
+    LIN_Observer_Chain(A First, B Second) : first(First), second(Second) { }
+
+    /// call both observers at start of receive handler
+    inline void onReceiveStart(LIN_Master &Lin)
+    {
+      first.onReceiveStart(Lin);
+      second.onReceiveStart(Lin);
+    }
+
+    /// call both observers after successful frame
+    inline void onFrameComplete(LIN_Master &Lin, uint8_t id, uint8_t numData, uint8_t *data)
+    {
+      first.onFrameComplete(Lin, id, numData, data);
+      second.onFrameComplete(Lin, id, numData, data);
+    }
+
+    /// call both observers after failed frame
+    inline void onFrameError(LIN_Master &Lin, LIN_error_t error)
+    {
+      first.onFrameError(Lin, error);
+      second.onFrameError(Lin, error);
+    }
+};
+
+
+
+/**
+  \brief  Frame statistics observer
+
+  \details Observer which counts successful frames and errors by type.
+*/
+class LIN_Observer_Stats : public LIN_Observer
+{
+  public:
+
+    // public variables
+    uint16_t    numFrames;                                                  //!< number of successful frames
+    uint16_t    numErrState;                                                //!< number of state machine errors
+    uint16_t    numErrEcho;                                                 //!< number of echo errors
+    uint16_t    numErrTimeout;                                              //!< number of timeouts
+    uint16_t    numErrChk;                                                  //!< number of checksum errors
+    uint16_t    numErrOther;                                                //!< number of other errors
+
+    /// class constructor
+    LIN_Observer_Stats() { reset(); }
+
+    /// reset all counters
+    void reset(void)
+    {
+      numFrames = numErrState = numErrEcho = numErrTimeout = numErrChk = numErrOther = 0;
+    }
+
+    /// count successful frame
+    inline void onFrameComplete(LIN_Master&, uint8_t, uint8_t, uint8_t*)
+    {
+      numFrames++;
+    }
+
+    /// count error by type
+    inline void onFrameError(LIN_Master&, LIN_error_t error)
+    {
+      switch (error)
+      {
+        case LIN_ERROR_STATE:   numErrState++;   break;
+        case LIN_ERROR_ECHO:    numErrEcho++;    break;
+        case LIN_ERROR_TIMEOUT: numErrTimeout++; break;
+        case LIN_ERROR_CHK:     numErrChk++;     break;
+        default:                numErrOther++;   break;
+      }
+    }
+};
+
+
+
+/**
+  \brief  Frame timing observer
+
+  \details Observer which tracks frame duration and slave response time per frame ID in log histograms, see
+           LIN_histogram.h. Up to N frame IDs are tracked, each with ~45 bytes. Timeouts are counted separately.
+           Durations are only measured in blocking operation. In background operation the receive handler is called
+           after the max. frame duration, i.e. the time of reception is unknown and only timeouts are counted.
+*/
+template <uint8_t N> class LIN_Observer_Timing : public LIN_Observer
+{
+  public:
+
+    // public variables
+    uint8_t        id[N];                                                   //!< tracked frame IDs. 0xFF = unused
+    LIN_Histogram  frame[N];                                                //!< frame duration incl. BREAK [us]
+    LIN_Histogram  response[N];                                             //!< slave response time after header [us]
+    uint16_t       numTimeout[N];                                           //!< number of timeouts
+    uint16_t       numUntracked;                                            //!< number of frames with ID beyond N tracked IDs
+
+    /// class constructor
+    LIN_Observer_Timing() { reset(); }
+
+    /// reset all statistics
+    void reset(void)
+    {
+      for (uint8_t i=0; i<N; i++)
+      {
+        id[i] = 0xFF;
+        frame[i].reset();
+        response[i].reset();
+        numTimeout[i] = 0;
+      }
+      numUntracked = 0;
+    }
+
+    /// get index of frame ID, or -1 if not tracked. If Add, start tracking new IDs
+    int8_t find(uint8_t Id, bool Add=false)
+    {
+      for (uint8_t i=0; i<N; i++)
+      {
+        if (id[i] == Id)
+          return i;
+        if (id[i] == 0xFF)
+        {
+          if (!Add)
+            return -1;
+          id[i] = Id;
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    /// add timing of successful frame
+    inline void onFrameComplete(LIN_Master &Lin, uint8_t, uint8_t, uint8_t*)
+    {
+      record(Lin);
+    }
+
+    /// count timeout
+    inline void onFrameError(LIN_Master &Lin, LIN_error_t)
+    {
+      record(Lin);
+    }
+
+  protected:
+
+    /// add result of last frame. Called in receive handler, i.e. result is consistent
+    void record(LIN_Master &Lin)
+    {
+      LIN_result_t  res;
+      int8_t        idx;
+
+      Lin.getResult(res);
+      idx = find(res.id, true);
+      if (idx < 0)
+      {
+        numUntracked++;
+        return;
+      }
+      if ((res.error == LIN_SUCCESS) && (res.timeFrame != 0))
+      {
+        frame[idx].add(res.timeFrame);
+        if (res.timeResponse != 0)
+          response[idx].add(res.timeResponse);
+      }
+      else if (res.error == LIN_ERROR_TIMEOUT)
+        numTimeout[idx]++;
+    }
+};
+
+/**
+  \brief  Payload fingerprint observer
+
+  \details Observer which hashes the data of each successful slave response (32 bit FNV-1a over length and data) and
+           compares it against a golden hash per frame ID, i.e. deviations are detected at full bus rate without
+           streaming frames. Master requests are ignored, as their data is set by this node. Golden hashes are set via
+           setGolden(), e.g. from a table recorded on a reference setup, or learned from the first frame of each ID
+           after learn(). Mismatches are counted per ID, and the first mismatching frame is captured. Up to N frame
+           IDs are tracked, each with 8 bytes.
+*/
+template <uint8_t N> class LIN_Observer_Fingerprint : public LIN_Observer
+{
+  public:
+
+    // public variables
+    uint8_t     id[N];                                                      //!< tracked frame IDs. 0xFF = unused
+    uint32_t    golden[N];                                                  //!< expected hash per frame ID
+    uint16_t    numMismatch[N];                                             //!< number of mismatching frames per ID
+    uint16_t    numFrames;                                                  //!< number of checked frames
+    uint16_t    numUnknown;                                                 //!< number of frames w/o golden hash
+    bool        learning;                                                   //!< learn golden hash of new IDs
+    uint8_t     firstId;                                                    //!< ID of first mismatch. 0xFF = none
+    uint8_t     firstNumData;                                               //!< number of data bytes of first mismatch
+    uint8_t     firstData[8];                                               //!< data bytes of first mismatch
+    uint16_t    firstFrame;                                                 //!< value of numFrames at first mismatch
+
+    /// class constructor
+    LIN_Observer_Fingerprint() { reset(); }
+
+    /// delete golden hashes and counters
+    void reset(void)
+    {
+      for (uint8_t i=0; i<N; i++)
+        id[i] = 0xFF;
+      learning = false;
+      clear();
+    }
+
+    /// reset counters and first mismatch, keep golden hashes
+    void clear(void)
+    {
+      for (uint8_t i=0; i<N; i++)
+        numMismatch[i] = 0;
+      numFrames    = 0;
+      numUnknown   = 0;
+      firstId      = 0xFF;
+      firstNumData = 0;
+    }
+
+    /// set golden hash of frame ID. Return false if N IDs are already tracked
+    bool setGolden(uint8_t Id, uint32_t Hash)
+    {
+      int8_t  idx = find(Id & 0x3F, true);
+
+      if (idx < 0)
+        return false;
+      golden[idx] = Hash;
+      return true;
+    }
+
+    /// learn golden hash from next frame of each untracked ID, until stopped via learn(false)
+    void learn(bool Learn=true) { learning = Learn; }
+
+    /// calculate 32 bit FNV-1a hash over length and data
+    static uint32_t hash(uint8_t numData, const uint8_t *data)
+    {
+      uint32_t  h = 2166136261UL;
+
+      h = (h ^ numData) * 16777619UL;
+      for (uint8_t i=0; i<numData; i++)
+        h = (h ^ data[i]) * 16777619UL;
+      return h;
+    }
+
+    /// get index of frame ID, or -1 if not tracked. If Add, start tracking new IDs
+    int8_t find(uint8_t Id, bool Add=false)
+    {
+      for (uint8_t i=0; i<N; i++)
+      {
+        if (id[i] == Id)
+          return i;
+        if (id[i] == 0xFF)
+        {
+          if (!Add)
+            return -1;
+          id[i] = Id;
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    /// compare hash of successful slave response against golden hash. Master requests are sent by this node
+    inline void onFrameComplete(LIN_Master &Lin, uint8_t Id, uint8_t numData, uint8_t *data)
+    {
+      LIN_result_t  res;
+      uint32_t      h;
+      int8_t        idx;
+
+      Lin.getResult(res);
+      if (res.type != LIN_SLAVE_RESPONSE)
+        return;
+      h   = hash(numData, data);
+      idx = find(Id);
+
+      numFrames++;
+
+      // unknown ID -> learn or count
+      if (idx < 0)
+      {
+        if ((!learning) || (!setGolden(Id, h)))
+          numUnknown++;
+        return;
+      }
+
+      // mismatch -> count and capture first
+      if (h != golden[idx])
+      {
+        numMismatch[idx]++;
+        if (firstId == 0xFF)
+        {
+          firstId      = Id;
+          firstNumData = numData;
+          firstFrame   = numFrames;
+          memcpy(firstData, data, numData);
+        }
+      }
+    }
+};
+
+
+
+/**
+  \brief  Response handling latency observer
+
+  \details Observer which tracks the latency from end of header until the slave response has been handled, i.e. until
+           received data is available to observers and callbacks. This includes slave response time, busy-wait
+           and checksum check, and in background operation the delay until the receive handler is called.
+           Jitter is given as spread of the latency. printCsv() exports the statistics as CSV, e.g. for comparison
+           with host-based LIN masters. Master requests are ignored, they have no response.
+*/
+class LIN_Observer_Latency : public LIN_Observer
+{
+  public:
+
+    // public variables
+    LIN_Histogram  latency;                                                 //!< end of header until response handled [us]
+    uint16_t       minLatency;                                              //!< minimum latency [us]
+    uint16_t       numTimeout;                                              //!< number of slave response timeouts
+
+    /// class constructor
+    LIN_Observer_Latency() { reset(); }
+
+    /// reset all statistics
+    void reset(void)
+    {
+      latency.reset();
+      minLatency = 0xFFFF;
+      numTimeout = 0;
+    }
+
+    /// get jitter, i.e. spread between minimum and given percentile [us]
+    uint16_t getJitter(uint8_t p=99)
+    {
+      return (latency.getCount() == 0) ? 0 : latency.percentile(p) - minLatency;
+    }
+
+    /// add latency of successful slave response
+    inline void onFrameComplete(LIN_Master &Lin, uint8_t, uint8_t, uint8_t*)
+    {
+      uint32_t      dt = micros() - Lin.getHeaderEnd();
+      uint16_t      value;
+      LIN_result_t  res;
+
+      // master request has no response -> ignore
+      Lin.getResult(res);
+      if ((res.type != LIN_SLAVE_RESPONSE) || ((int32_t) dt < 0))
+        return;
+      value = (dt > 0xFFFF) ? 0xFFFF : (uint16_t) dt;
+      latency.add(value);
+      if (value < minLatency)
+        minLatency = value;
+    }
+
+    /// count slave response timeouts
+    inline void onFrameError(LIN_Master&, LIN_error_t error)
+    {
+      if (error == LIN_ERROR_TIMEOUT)
+        numTimeout++;
+    }
+
+    /// print statistics as CSV header and line: samples, timeouts, min, p50, p99, max and jitter [us]
+    void printCsv(Print &Out)
+    {
+      bool  empty = (latency.getCount() == 0);
+
+      Out.println("samples,timeouts,min_us,p50_us,p99_us,max_us,jitter_us");
+      Out.print(latency.getCount());               Out.print(',');
+      Out.print(numTimeout);                       Out.print(',');
+      Out.print(empty ? 0 : minLatency);           Out.print(',');
+      Out.print(latency.percentile(50));           Out.print(',');
+      Out.print(latency.percentile(99));           Out.print(',');
+      Out.print(latency.getMax());                 Out.print(',');
+      Out.println(getJitter(99));
+    }
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_OBSERVER_H_
@@ -0,0 +1,127 @@
+/**
+  \file     LIN_registry.cpp
+  \brief    Frame ID indexed handler registry for LIN master emulation
+  \details  This library provides a registry where frame lengths, buffers and response handlers are registered
+            once per frame ID. A LIN_Master with attached registry starts frames by ID only and dispatches
+            received slave responses in O(1) from the received ID.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_registry.h"
+
+
+/**
+  \brief      Constructor for handler registry
+  \details    Constructor for handler registry. Initially no frame ID is registered.
+*/
+LIN_Registry::LIN_Registry()
+{
+  for (uint8_t i=0; i<LIN_REGISTRY_SIZE; i++)
+    remove(i);
+
+} // LIN_Registry::LIN_Registry()
+
+
+
+/**
+  \brief      Register frame ID
+  \details    Register length, buffer and optional response handler of a frame ID. For master requests data holds
+              the Tx data. For slave responses received data is copied to data (if not NULL) and passed to callback
+              (if not NULL). Buffers must remain valid while registered.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  numData     number of data bytes (0..8)
+  \param[in]  data        Tx data or Rx buffer, or NULL
+  \param[in]  callback    callback for slave response, or NULL
+  \param[in]  context     context pointer passed to callback
+*/
+void LIN_Registry::add(uint8_t id, uint8_t numData, uint8_t *data, LIN_callback_t callback, void *context)
+{
+  LIN_registry_entry_t  *e = &(entry[id & 0x3F]);
+
+  // avoid inconsistent entry if LIN master dispatches concurrently
+  LIN_irq_t s = LIN_irqSave();
+  e->numData  = (numData > 8) ? 8 : numData;
+  e->data     = data;
+  e->callback = callback;
+  e->context  = context;
+  LIN_irqRestore(s);
+
+} // LIN_Registry::add()
+
+
+
+/**
+  \brief      Unregister frame ID
+  \details    Unregister frame ID. Frames with this ID can no longer be started by ID.
+  \param[in]  id          frame ID (protection optional)
+*/
+void LIN_Registry::remove(uint8_t id)
+{
+  LIN_registry_entry_t  *e = &(entry[id & 0x3F]);
+
+  LIN_irq_t s = LIN_irqSave();
+  e->numData  = LIN_REGISTRY_NONE;
+  e->data     = NULL;
+  e->callback = NULL;
+  e->context  = NULL;
+  LIN_irqRestore(s);
+
+} // LIN_Registry::remove()
+
+
+
+/**
+  \brief      Check if frame ID is registered
+  \details    Check if frame ID is registered.
+  \param[in]  id          frame ID (protection optional)
+  \return     true if registered
+*/
+bool LIN_Registry::contains(uint8_t id)
+{
+  return (entry[id & 0x3F].numData != LIN_REGISTRY_NONE);
+
+} // LIN_Registry::contains()
+
+
+
+/**
+  \brief      Get entry of frame ID
+  \details    Get registry entry of frame ID in O(1).
+  \param[in]  id          frame ID (protection optional)
+  \return     entry, or NULL if not registered
+*/
+const LIN_registry_entry_t *LIN_Registry::get(uint8_t id)
+{
+  return contains(id) ? &(entry[id & 0x3F]) : NULL;
+
+} // LIN_Registry::get()
+
+
+
+/**
+  \brief      Dispatch received data
+  \details    Copy received slave response to registered buffer and call registered callback in O(1).
+              Called by LIN_Master receive handler.
+  \param[in]  id          received frame ID (protection optional)
+  \param[in]  numData     number of received data bytes
+  \param[in]  data        received data bytes
+*/
+void LIN_Registry::dispatch(uint8_t id, uint8_t numData, uint8_t *data)
+{
+  LIN_registry_entry_t  *e = &(entry[id & 0x3F]);
+
+  // ID not registered
+  if (e->numData == LIN_REGISTRY_NONE)
+    return;
+
+  // copy to buffer and call handler
+  if (e->data != NULL)
+    memcpy(e->data, data, (numData < e->numData) ? numData : e->numData);
+  if (e->callback != NULL)
+    e->callback(e->context, numData, data);
+
+} // LIN_Registry::dispatch()
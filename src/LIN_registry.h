@@ -0,0 +1,84 @@
+/**
+  \file     LIN_registry.h
+  \brief    Frame ID indexed handler registry for LIN master emulation
+  \details  This library provides a registry where frame lengths, buffers and response handlers are registered
+            once per frame ID. A LIN_Master with attached registry starts frames by ID only and dispatches
+            received slave responses in O(1) from the received ID.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_REGISTRY_H_
+#define _LIN_REGISTRY_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_REGISTRY_SIZE   64          //!< number of frame IDs (0x00..0x3F)
+#define LIN_REGISTRY_NONE   0xFF        //!< numData of unregistered frame ID
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief entry of handler registry
+*/
+typedef struct {
+    uint8_t           numData;      //!< number of data bytes (0..8), or LIN_REGISTRY_NONE
+    uint8_t           *data;        //!< Tx data (master request) or Rx buffer (slave response), or NULL
+    LIN_callback_t    callback;     //!< callback for slave response, or NULL
+    void              *context;     //!< context pointer passed to callback
+} LIN_registry_entry_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Frame ID indexed handler registry
+
+  \details Registry of frame length, buffer and response handler per frame ID. Attach to a LIN_Master via
+           LIN_Master::attachRegistry(), then use sendMasterRequest(id) and receiveSlaveResponse(id).
+           Requires ~7 bytes per frame ID on AVR, therefore it is optional and may be shared by several masters.
+*/
+class LIN_Registry
+{
+  protected:
+
+    // internal variables
+    LIN_registry_entry_t  entry[LIN_REGISTRY_SIZE];                         //!< entries indexed by frame ID
+
+  public:
+
+    // public methods
+    LIN_Registry();                                                         //!< class constructor
+    void                  add(uint8_t id, uint8_t numData, uint8_t *data, LIN_callback_t callback=NULL, void *context=NULL);  //!< register frame ID
+    void                  remove(uint8_t id);                               //!< unregister frame ID
+    bool                  contains(uint8_t id);                             //!< check if frame ID is registered
+    const LIN_registry_entry_t *get(uint8_t id);                            //!< get entry of frame ID, or NULL
+    void                  dispatch(uint8_t id, uint8_t numData, uint8_t *data);  //!< pass received data to handler of frame ID
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_REGISTRY_H_
@@ -0,0 +1,208 @@
+/**
+  \file     LIN_scanner.cpp
+  \brief    Fast bus enumeration for LIN master emulation
+  \details  This library probes all frame IDs 0x00..0x3B of a LIN bus with baud-derived short timeouts and detects
+            response length and checksum model. Optionally all NADs are probed via diagnostic frames 0x3C/0x3D.
+            Scanners are non-blocking, i.e. all buses are scanned concurrently.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_scanner.h"
+#include "LIN_schedule.h"
+
+
+/**
+  \brief      Constructor for bus scanner
+  \details    Constructor for bus scanner. Scan is not started.
+  \param[in]  LIN         LIN master to scan. Must be started via begin()
+*/
+LIN_Scanner::LIN_Scanner(LIN_Master &LIN)
+{
+  pLIN    = &LIN;
+  state   = LIN_SCAN_DONE;
+  idx     = 0;
+  scanNAD = false;
+  started = false;
+  memset(frameInfo, 0, LIN_SCAN_IDS);
+  memset(nad, 0, sizeof(nad));
+
+} // LIN_Scanner::LIN_Scanner()
+
+
+
+/**
+  \brief      Start bus scan
+  \details    Delete previous results and start scan with frame ID 0x00.
+  \param[in]  NAD         also probe NADs 0x01..0x7D via diagnostic frames
+*/
+void LIN_Scanner::start(bool NAD)
+{
+  memset(frameInfo, 0, LIN_SCAN_IDS);
+  memset(nad, 0, sizeof(nad));
+  scanNAD = NAD;
+  state   = LIN_SCAN_ID;
+  idx     = 0;
+  started = false;
+
+} // LIN_Scanner::start()
+
+
+
+/**
+  \brief      Run bus scan
+  \details    Non-blocking scan step. Starts the next probe if LIN master is idle, else polls the own ongoing probe.
+              Frames of other contexts are not polled, instead the probe is started after they have finished.
+              Call from loop() until false is returned.
+  \return     true while scan is ongoing
+*/
+bool LIN_Scanner::task(void)
+{
+  LIN_probe_t  probe;
+  uint8_t      request[8];
+  bool         done = false;
+
+  switch (state)
+  {
+    // probe frame IDs 0x00..0x3B
+    case LIN_SCAN_ID:
+
+      // start probe. Header error or bus fault counts as no response
+      if ((!started) && (pLIN->getState() == LIN_STATE_IDLE))
+      {
+        done    = ((pLIN->startProbe(idx) != LIN_SUCCESS) || (pLIN->getState() != LIN_STATE_FRAME));
+        started = !done;
+      }
+
+      // own probe finished -> store result
+      else if ((started) && (pLIN->pollProbe(probe)))
+      {
+        if ((probe.error == LIN_SUCCESS) && (probe.model != LIN_CHK_NONE))
+          frameInfo[idx] = probe.numData | (probe.model << 4);
+        started = false;
+        done    = true;
+      }
+
+      // continue with next ID, then NADs
+      if ((done) && (++idx >= LIN_SCAN_IDS))
+      {
+        idx   = 1;
+        state = (scanNAD) ? LIN_SCAN_NAD_REQUEST : LIN_SCAN_DONE;
+      }
+      return true;
+
+    // send ReadByIdentifier(0) to next NAD
+    case LIN_SCAN_NAD_REQUEST:
+      if (pLIN->getState() == LIN_STATE_IDLE)
+      {
+        request[0] = idx;         // NAD
+        request[1] = 0x06;        // PCI: single frame, 6 bytes
+        request[2] = 0xB2;        // SID: ReadByIdentifier
+        request[3] = 0x00;        // identifier 0: LIN product identification
+        request[4] = 0xFF;        // supplier ID wildcard
+        request[5] = 0x7F;
+        request[6] = 0xFF;        // function ID wildcard
+        request[7] = 0xFF;
+        if (pLIN->sendMasterRequest(LIN_ID_MASTER_REQ, 8, request) == LIN_SUCCESS)
+          state = LIN_SCAN_NAD_RESPONSE;
+        else
+          done = true;
+      }
+      break;
+
+    // poll slave response of NAD
+    case LIN_SCAN_NAD_RESPONSE:
+
+      // start probe after master request has finished
+      if ((!started) && (pLIN->getState() == LIN_STATE_IDLE))
+      {
+        done    = ((pLIN->startProbe(LIN_ID_SLAVE_RESP) != LIN_SUCCESS) || (pLIN->getState() != LIN_STATE_FRAME));
+        started = !done;
+      }
+
+      // positive response with matching NAD -> node found
+      else if ((started) && (pLIN->pollProbe(probe)))
+      {
+        if ((probe.error == LIN_SUCCESS) && (probe.model == LIN_CHK_CLASSIC) && (probe.numData == 8) &&
+            (probe.data[0] == idx) && (probe.data[2] == 0xF2))
+          nad[idx >> 3] |= (uint8_t) (1 << (idx & 0x07));
+        started = false;
+        done    = true;
+      }
+      break;
+
+    // scan finished
+    default:
+      return false;
+
+  } // switch (state)
+
+  // NAD finished -> continue with next NAD
+  if ((done) && (state != LIN_SCAN_ID))
+    state = (++idx > LIN_SCAN_NAD_MAX) ? LIN_SCAN_DONE : LIN_SCAN_NAD_REQUEST;
+
+  return true;
+
+} // LIN_Scanner::task()
+
+
+
+/**
+  \brief      Check if frame ID responded
+  \details    Check if a slave response was received for frame ID in last scan.
+  \param[in]  id          frame ID (protection optional)
+  \return     true if slave responded
+*/
+bool LIN_Scanner::answered(uint8_t id)
+{
+  id &= 0x3F;
+  return ((id < LIN_SCAN_IDS) && (frameInfo[id] != 0));
+
+} // LIN_Scanner::answered()
+
+
+
+/**
+  \brief      Get detected response length
+  \details    Get number of data bytes detected for frame ID in last scan.
+  \param[in]  id          frame ID (protection optional)
+  \return     number of data bytes, 0 if no response
+*/
+uint8_t LIN_Scanner::getLength(uint8_t id)
+{
+  return answered(id) ? (frameInfo[id & 0x3F] & 0x0F) : 0;
+
+} // LIN_Scanner::getLength()
+
+
+
+/**
+  \brief      Get detected checksum model
+  \details    Get checksum model detected for frame ID in last scan.
+  \param[in]  id          frame ID (protection optional)
+  \return     checksum model, LIN_CHK_NONE if no response
+*/
+LIN_checksum_t LIN_Scanner::getModel(uint8_t id)
+{
+  return answered(id) ? (LIN_checksum_t) (frameInfo[id & 0x3F] >> 4) : LIN_CHK_NONE;
+
+} // LIN_Scanner::getModel()
+
+
+
+/**
+  \brief      Check if NAD responded
+  \details    Check if a node with NAD answered ReadByIdentifier(0) in last scan.
+  \param[in]  NAD         node address (0x01..0x7D)
+  \return     true if node responded
+*/
+bool LIN_Scanner::nadFound(uint8_t NAD)
+{
+  if (NAD > LIN_SCAN_NAD_MAX)
+    return false;
+  return (nad[NAD >> 3] & (1 << (NAD & 0x07)));
+
+} // LIN_Scanner::nadFound()
@@ -0,0 +1,95 @@
+/**
+  \file     LIN_scanner.h
+  \brief    Fast bus enumeration for LIN master emulation
+  \details  This library probes all frame IDs 0x00..0x3B of a LIN bus with baud-derived short timeouts and detects
+            response length and checksum model. Optionally all NADs are probed via diagnostic frames 0x3C/0x3D.
+            Scanners are non-blocking, i.e. all buses are scanned concurrently.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_SCANNER_H_
+#define _LIN_SCANNER_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_SCAN_IDS        60          //!< number of scanned frame IDs (0x00..0x3B)
+#define LIN_SCAN_NAD_MAX    0x7D        //!< highest scanned NAD (0x7E/0x7F are functional/broadcast)
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief state of bus scanner
+*/
+typedef enum {
+    LIN_SCAN_ID           = 0,      //!< probing frame IDs
+    LIN_SCAN_NAD_REQUEST  = 1,      //!< master request 0x3C for NAD pending
+    LIN_SCAN_NAD_RESPONSE = 2,      //!< slave response 0x3D for NAD pending
+    LIN_SCAN_DONE         = 3       //!< scan finished
+} LIN_scan_state_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  LIN bus scanner
+
+  \details Enumerate frame IDs and NADs of a LIN bus. Call start(), then task() from loop() until it returns false.
+           Per frame ID only one short header is sent and the response is polled with LIN_PROBE_SPACE/LIN_PROBE_GAP
+           bit timeouts instead of the max. frame duration, i.e. an empty ID costs ~80 Tbit (~4.2ms at 19.2kBaud).
+           Several scanners run concurrently, e.g. `while (scan1.task() | scan2.task());`.
+           NADs are probed with ReadByIdentifier(0) and accepted if a positive response with matching NAD is received.
+*/
+class LIN_Scanner
+{
+  protected:
+
+    // internal variables
+    LIN_Master        *pLIN;                                                //!< scanned LIN master
+    LIN_scan_state_t  state;                                                //!< state of scanner
+    uint8_t           idx;                                                  //!< current frame ID or NAD
+    bool              scanNAD;                                              //!< also probe NADs
+    bool              started;                                              //!< own probe was started, i.e. is polled
+
+  public:
+
+    // public variables
+    uint8_t           frameInfo[LIN_SCAN_IDS];                              //!< numData | model<<4 per frame ID, 0 = no response
+    uint8_t           nad[16];                                              //!< bitmask of responding NADs
+
+    // public methods
+    LIN_Scanner(LIN_Master &LIN);                                           //!< class constructor
+    void              start(bool NAD=true);                                 //!< start scan
+    bool              task(void);                                           //!< run scan. Return true while scanning
+    bool              answered(uint8_t id);                                 //!< check if frame ID responded
+    uint8_t           getLength(uint8_t id);                                //!< get detected number of data bytes
+    LIN_checksum_t    getModel(uint8_t id);                                 //!< get detected checksum model
+    bool              nadFound(uint8_t NAD);                                //!< check if NAD responded
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_SCANNER_H_
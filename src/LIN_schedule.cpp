@@ -0,0 +1,611 @@
+/**
+  \file     LIN_schedule.cpp
+  \brief    Schedule table for LIN master emulation
+  \details  This library provides a schedule table for a LIN_Master. Application frames are executed
+            slot by slot, and diagnostic frames (MasterReq 0x3C / SlaveResp 0x3D) are interleaved into
+            the running schedule at a configurable ratio. Rules on received signals switch the table or insert
+            frames directly from the receive path.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_schedule.h"
+#include "LIN_atomic.h"
+
+
+/**
+  \brief      Constructor for LIN schedule
+  \details    Constructor for LIN schedule. Initially no table is set and diagnostic slots alternate with application slots.
+  \param[in]  Lin         LIN master instance
+*/
+LIN_Schedule::LIN_Schedule(LIN_Master &Lin)
+{
+  // store LIN master
+  pLIN = &Lin;
+
+  // reset internal variables
+  table         = NULL;
+  numEntries    = 0;
+  idxEntry      = 0;
+  diagRatio     = 1;
+  countApp      = 0;
+  diagState     = LIN_DIAG_IDLE;
+  diagResponse  = NULL;
+  diagHandler   = NULL;
+  diagCallback  = NULL;
+  diagContext   = NULL;
+  diagWait      = false;
+  seqDiag       = 0;
+  diagRetry     = 0;
+  diagFailed    = false;
+  slotTime      = 0;
+  tSlotStart    = 0;
+  headFiller    = 0;
+  tailFiller    = 0;
+  rules         = NULL;
+  numRules      = 0;
+  ruleState     = 0;
+  ruleTriggered = 0;
+  nextTable     = NULL;
+  numNext       = 0;
+  switchPending = false;
+  insertTable   = NULL;
+  numInsert     = 0;
+  idxInsert     = 0;
+
+} // LIN_Schedule::LIN_Schedule()
+
+
+
+/**
+  \brief      Set application schedule table
+  \details    Set application schedule table. Execution restarts with first entry in next slot.
+  \param[in]  Table       schedule table. Must remain valid while in use. NULL for diagnostics only
+  \param[in]  NumEntries  number of entries in table
+*/
+void LIN_Schedule::setTable(const LIN_schedule_entry_t *Table, uint8_t NumEntries)
+{
+  // avoid inconsistent table if tick() is called by task scheduler
+  LIN_irq_t s = LIN_irqSave();
+  table      = Table;
+  numEntries = (Table == NULL) ? 0 : NumEntries;
+  idxEntry   = 0;
+  LIN_irqRestore(s);
+
+} // LIN_Schedule::setTable()
+
+
+
+/**
+  \brief      Set ratio of application to diagnostic slots
+  \details    Set number of application slots between two diagnostic slots. Diagnostic slots are only
+              used if a diagnostic frame is pending, otherwise the application schedule continues.
+  \param[in]  Ratio       application slots per diagnostic slot. 0 = pause application while diagnostics are pending
+*/
+void LIN_Schedule::setDiagnosticRatio(uint8_t Ratio)
+{
+  // store ratio
+  diagRatio = Ratio;
+
+} // LIN_Schedule::setDiagnosticRatio()
+
+
+
+/**
+  \brief      Queue diagnostic request
+  \details    Queue a diagnostic master request (ID 0x3C) for the next diagnostic slot. If a response
+              buffer or handler is given, a slave response (ID 0x3D) is requested in the subsequent diagnostic slot.
+              If a frame still fails after LIN_SCHEDULE_RETRY repetitions the transfer is dropped, see diagnosticFailed().
+  \param[in]  request     8 data bytes of master request (NAD, PCI, SID, ...)
+  \param[out] response    buffer for 8 data bytes of slave response, or NULL
+  \param[in]  handler     callback for slave response, or NULL
+  \return     LIN_ERROR_STATE if a diagnostic frame is still pending
+*/
+LIN_error_t LIN_Schedule::queueDiagnostic(const uint8_t *request, uint8_t *response, decoder_t handler)
+{
+  // only one diagnostic transfer at a time
+  if (diagState != LIN_DIAG_IDLE)
+    return LIN_ERROR_STATE;
+
+  // store request and response handling
+  memcpy(diagRequest, request, 8);
+  diagResponse = response;
+  diagHandler  = handler;
+  diagCallback = NULL;
+  diagRetry    = 0;
+  diagFailed   = false;
+
+  // activate diagnostic channel last
+  diagState = LIN_DIAG_REQUEST;
+
+  return LIN_SUCCESS;
+
+} // LIN_Schedule::queueDiagnostic()
+
+
+
+/**
+  \brief      Queue diagnostic response poll
+  \details    Queue a diagnostic slave response (ID 0x3D) for the next diagnostic slot without a preceding master
+              request, e.g. to poll a segmented response or a slave which is not yet ready. The callback is only called
+              if a valid response was received. A failed poll is repeated up to LIN_SCHEDULE_RETRY times, then the
+              channel is released and diagnosticFailed() is set, i.e. the caller polls again or times out.
+  \param[in]  Callback    context callback for slave response
+  \param[in]  Context     context pointer passed to callback
+  \return     LIN_ERROR_STATE if a diagnostic frame is still pending
+*/
+LIN_error_t LIN_Schedule::queueDiagnosticResponse(LIN_callback_t Callback, void *Context)
+{
+  // only one diagnostic transfer at a time
+  if (diagState != LIN_DIAG_IDLE)
+    return LIN_ERROR_STATE;
+
+  // store response handling
+  diagResponse = NULL;
+  diagHandler  = NULL;
+  diagCallback = Callback;
+  diagContext  = Context;
+  diagRetry    = 0;
+  diagFailed   = false;
+
+  // activate diagnostic channel last
+  diagState = LIN_DIAG_RESPONSE;
+
+  return LIN_SUCCESS;
+
+} // LIN_Schedule::queueDiagnosticResponse()
+
+
+
+/**
+  \brief      Check if diagnostic frame is pending
+  \details    Check if a diagnostic master request or slave response is still pending.
+  \return     true if diagnostic frame is pending
+*/
+bool LIN_Schedule::diagnosticPending(void)
+{
+  return (diagState != LIN_DIAG_IDLE);
+
+} // LIN_Schedule::diagnosticPending()
+
+
+
+/**
+  \brief      Check if last diagnostic transfer failed
+  \details    Check if the last diagnostic transfer was dropped because a frame still failed after LIN_SCHEDULE_RETRY
+              repetitions. Reset when the next transfer is queued.
+  \return     true if last diagnostic transfer failed
+*/
+bool LIN_Schedule::diagnosticFailed(void)
+{
+  return diagFailed;
+
+} // LIN_Schedule::diagnosticFailed()
+
+
+
+/**
+  \brief      Execute next slot
+  \details    Execute next slot of schedule. Call once per slot, e.g. via task scheduler.
+              A diagnostic slot is used if a diagnostic frame is pending and diagRatio application slots have passed,
+              or if no application table is set. Table switches and inserted frames of triggered rules take
+              effect first.
+*/
+void LIN_Schedule::tick(void)
+{
+  const LIN_schedule_entry_t  *entry = NULL;
+  LIN_irq_t                   s;
+
+  // store start of slot for background frames
+  tSlotStart = micros();
+
+  // apply actions of triggered rules. Rules are evaluated in receive handler
+  s = LIN_irqSave();
+  if (switchPending)
+  {
+    table         = nextTable;
+    numEntries    = (nextTable == NULL) ? 0 : numNext;
+    idxEntry      = 0;
+    switchPending = false;
+  }
+  if (idxInsert < numInsert)
+    entry = &(insertTable[idxInsert++]);
+  LIN_irqRestore(s);
+
+  // inserted frame slot
+  if (entry != NULL)
+  {
+    LIN_TRACE_EVENT(LIN_TRACE_TICK, 0, 0xFE);
+    runFrame(entry->type, entry->id, entry->numData, entry->data, entry->handler);
+    return;
+  }
+
+  // diagnostic slot. Wait until result of previous diagnostic frame is known
+  checkDiagnostic();
+  if ((diagState != LIN_DIAG_IDLE) && (!diagWait) && ((numEntries == 0) || (countApp >= diagRatio)))
+  {
+    LIN_TRACE_EVENT(LIN_TRACE_TICK, 0, 0xFF);
+    countApp = 0;
+    runDiagnostic();
+    return;
+  }
+
+  // no application table
+  if (numEntries == 0)
+    return;
+
+  // application slot
+  LIN_TRACE_EVENT(LIN_TRACE_TICK, 0, idxEntry);
+  entry = &(table[idxEntry]);
+  runFrame(entry->type, entry->id, entry->numData, entry->data, entry->handler);
+  if (++idxEntry >= numEntries)
+    idxEntry = 0;
+  if (countApp < 255)
+    countApp++;
+
+} // LIN_Schedule::tick()
+
+
+
+/**
+  \brief      Set slot time
+  \details    Set slot time, i.e. period of tick() calls. Required for background frames, see idle().
+              In background operation of the LIN master each frame occupies it for the task scheduler delays
+              (~8.5ms at 19.2kBaud, ~15.5ms below 12kBaud), see LIN_Master::frameDurationMax(). I.e. background frames
+              only fit into slots of >=20ms (>=32ms below 12kBaud). In blocking operation the nominal frame
+              durations apply.
+  \param[in]  SlotTime    slot time [ms]. 0 = disable background frames
+*/
+void LIN_Schedule::setSlotTime(uint16_t SlotTime)
+{
+  // store slot time
+  slotTime = SlotTime;
+
+} // LIN_Schedule::setSlotTime()
+
+
+
+/**
+  \brief      Queue low-priority background frame
+  \details    Queue a low-priority frame, e.g. diagnostic polling or inventory reads. It is sent by idle() only if
+              the remaining time of the current slot exceeds its worst-case duration, i.e. without affecting the timing
+              of application frames. The frame data is copied, buffers referenced by it must remain valid.
+  \param[in]  Frame       frame to send
+  \return     false if queue is full
+*/
+bool LIN_Schedule::queueBackground(const LIN_schedule_entry_t &Frame)
+{
+  uint8_t  next = (headFiller + 1) % LIN_SCHEDULE_FILLER;
+
+  // queue full
+  if (next == tailFiller)
+    return false;
+
+  // store frame
+  filler[headFiller] = Frame;
+  headFiller = next;
+
+  return true;
+
+} // LIN_Schedule::queueBackground()
+
+
+
+/**
+  \brief      Check if background frames are queued
+  \details    Check if background frames are queued and not yet sent, e.g. to feed the queue one frame at a time.
+  \return     true if background frames are queued
+*/
+bool LIN_Schedule::backgroundPending(void)
+{
+  return (headFiller != tailFiller);
+
+} // LIN_Schedule::backgroundPending()
+
+
+
+/**
+  \brief      Send background frame if slot time suffices
+  \details    Send the oldest queued background frame if the LIN master is idle and the remaining time of the current
+              slot exceeds the worst-case frame duration. Call frequently from the task scheduler (e.g. every 1ms),
+              not from loop(), to avoid races with tick(). If the LIN master rejects the frame (e.g. bus fault), it
+              stays queued and is retried.
+*/
+void LIN_Schedule::idle(void)
+{
+  const LIN_schedule_entry_t  *frame;
+  uint32_t                    elapsed;
+
+  // nothing to do or slot time unknown
+  if ((headFiller == tailFiller) || (slotTime == 0))
+    return;
+
+  // LIN master busy with application frame
+  if (pLIN->getState() != LIN_STATE_IDLE)
+    return;
+
+  // evaluate diagnostic frame before its result is overwritten
+  checkDiagnostic();
+
+  // check remaining slot time against worst-case frame duration
+  frame   = &(filler[tailFiller]);
+  elapsed = micros() - tSlotStart;
+  if ((elapsed >= (uint32_t) slotTime * 1000L) || ((uint32_t) slotTime * 1000L - elapsed < pLIN->frameDurationMax(frame->numData)))
+    return;
+
+  // send frame. Remove from queue only if started, else retry later. A configuration error (e.g. no registry)
+  // never succeeds -> drop frame to avoid blocking the queue
+  LIN_error_t res = runFrame(frame->type, frame->id, frame->numData, frame->data, frame->handler);
+  if ((res == LIN_SUCCESS) || (res == LIN_ERROR_MISC))
+    tailFiller = (tailFiller + 1) % LIN_SCHEDULE_FILLER;
+
+} // LIN_Schedule::idle()
+
+
+
+/**
+  \brief      Set reactive rules
+  \details    Set rules which switch the schedule table or insert frames when a received signal meets a condition,
+              e.g. switch to a diagnostic table if a slave reports an error. Rules are edge triggered, i.e. an action
+              is executed once when the condition becomes true. It takes effect in the next slot. Rules are evaluated
+              by evaluate(), e.g. via LIN_Master::attachFrameHook(LIN_Schedule::ruleHook, &schedule), or from a
+              frame observer if the frame hook is already used.
+  \param[in]  Rules       rule table. Must remain valid while in use. NULL to remove rules
+  \param[in]  Num         number of rules (max. LIN_SCHEDULE_RULES)
+*/
+void LIN_Schedule::setRules(const LIN_schedule_rule_t *Rules, uint8_t Num)
+{
+  // avoid inconsistent rules if receive handler evaluates concurrently
+  LIN_irq_t s = LIN_irqSave();
+  rules         = Rules;
+  numRules      = (Rules == NULL) ? 0 : ((Num > LIN_SCHEDULE_RULES) ? LIN_SCHEDULE_RULES : Num);
+  ruleState     = 0;
+  ruleTriggered = 0;
+  LIN_irqRestore(s);
+
+} // LIN_Schedule::setRules()
+
+
+
+/**
+  \brief      Evaluate rules for received frame
+  \details    Evaluate all rules for the frame ID and store actions of rules whose condition became true. Called in
+              receive path after each successful frame, i.e. application code is not involved.
+  \param[in]  id          frame ID (protection optional)
+  \param[in]  numData     number of data bytes
+  \param[in]  data        data bytes
+*/
+void LIN_Schedule::evaluate(uint8_t id, uint8_t numData, uint8_t *data)
+{
+  const LIN_schedule_rule_t  *rule;
+  uint16_t                   mask;
+  bool                       cond;
+
+  id &= 0x3F;
+  for (uint8_t i=0; i<numRules; i++)
+  {
+    rule = &(rules[i]);
+    if ((rule->id & 0x3F) != id)
+      continue;
+
+    // only execute action on rising edge of condition
+    mask = (uint16_t) 1 << i;
+    cond = checkRule(rule, numData, data);
+    if (!cond)
+    {
+      ruleState &= ~mask;
+      continue;
+    }
+    if (ruleState & mask)
+      continue;
+    ruleState     |= mask;
+    ruleTriggered |= mask;
+
+    // store action for next slot. A later rule overrides an earlier one
+    if (rule->action == LIN_RULE_SWITCH)
+    {
+      nextTable     = rule->entries;
+      numNext       = rule->numEntries;
+      switchPending = true;
+    }
+    else
+    {
+      numInsert   = 0;                  // disable insertion while updating
+      insertTable = rule->entries;
+      idxInsert   = 0;
+      numInsert   = (rule->entries == NULL) ? 0 : rule->numEntries;
+    }
+  }
+
+} // LIN_Schedule::evaluate()
+
+
+
+/**
+  \brief      Get triggered rules
+  \details    Get rules triggered since last call, e.g. to inform application. Flags are cleared.
+  \return     bitmask of triggered rules (bit i = rule i)
+*/
+uint16_t LIN_Schedule::getTriggered(void)
+{
+  LIN_irq_t  s = LIN_irqSave();
+  uint16_t   mask = ruleTriggered;
+  ruleTriggered = 0;
+  LIN_irqRestore(s);
+
+  return mask;
+
+} // LIN_Schedule::getTriggered()
+
+
+
+/**
+  \brief      Frame hook for rule evaluation
+  \details    Frame hook for LIN_Master::attachFrameHook() which evaluates the rules of a schedule.
+  \param[in]  Context     pointer to LIN_Schedule
+  \param[in]  id          frame ID
+  \param[in]  numData     number of data bytes
+  \param[in]  data        data bytes
+*/
+void LIN_Schedule::ruleHook(void *Context, uint8_t id, uint8_t numData, uint8_t *data)
+{
+  ((LIN_Schedule*) Context)->evaluate(id, numData, data);
+
+} // LIN_Schedule::ruleHook()
+
+
+
+/**
+  \brief      Execute a diagnostic slot
+  \details    Send pending diagnostic master request or request pending slave response. The diagnostic channel
+              advances only after the frame has finished successfully, see checkDiagnostic().
+              If the frame can't be started (e.g. LIN master busy) it is repeated in the next diagnostic slot.
+*/
+void LIN_Schedule::runDiagnostic(void)
+{
+  LIN_result_t  res;
+  uint8_t       seq = pLIN->getResult(res);
+
+  // master request
+  if (diagState == LIN_DIAG_REQUEST)
+  {
+    if (runFrame(LIN_MASTER_REQUEST, LIN_ID_MASTER_REQ, 8, diagRequest, NULL) != LIN_SUCCESS)
+      return;
+  }
+
+  // slave response
+  else if (diagState == LIN_DIAG_RESPONSE)
+  {
+    if (diagCallback != NULL)
+    {
+      if (pLIN->receiveSlaveResponse(LIN_ID_SLAVE_RESP, 8, diagCallback, diagContext) != LIN_SUCCESS)
+        return;
+    }
+    else if (runFrame(LIN_SLAVE_RESPONSE, LIN_ID_SLAVE_RESP, 8, diagResponse, diagHandler) != LIN_SUCCESS)
+      return;
+  }
+
+  // check result when frame has finished
+  seqDiag  = seq;
+  diagWait = true;
+
+} // LIN_Schedule::runDiagnostic()
+
+
+
+/**
+  \brief      Advance diagnostic channel after frame result
+  \details    Check result of the started diagnostic frame once the LIN master is idle again. On success the channel
+              advances to the slave response or is released. A failed frame (e.g. echo error or timeout) is repeated
+              in the next diagnostic slot, up to LIN_SCHEDULE_RETRY times, then the transfer is dropped and
+              diagnosticFailed() is set. A result sequence other than the next one means the frame was aborted
+              or its result was overwritten, then the frame is repeated as well.
+*/
+void LIN_Schedule::checkDiagnostic(void)
+{
+  LIN_result_t  res;
+  uint8_t       seq;
+
+  // no diagnostic frame started or still running
+  if ((!diagWait) || (pLIN->getState() != LIN_STATE_IDLE))
+    return;
+  diagWait = false;
+
+  // failed or result of other frame -> repeat, or give up after max. retries
+  seq = pLIN->getResult(res);
+  if ((seq != (uint8_t) (seqDiag + 2)) || (res.error != LIN_SUCCESS) ||
+      ((diagState == LIN_DIAG_REQUEST) && ((res.id != LIN_ID_MASTER_REQ) || (res.type != LIN_MASTER_REQUEST))) ||
+      ((diagState == LIN_DIAG_RESPONSE) && ((res.id != LIN_ID_SLAVE_RESP) || (res.type != LIN_SLAVE_RESPONSE))))
+  {
+    if (++diagRetry > LIN_SCHEDULE_RETRY)
+    {
+      diagRetry  = 0;
+      diagFailed = true;
+      diagState  = LIN_DIAG_IDLE;
+    }
+    return;
+  }
+
+  // success -> next frame of diagnostic transfer
+  diagRetry = 0;
+  if (diagState == LIN_DIAG_REQUEST)
+    diagState = ((diagResponse != NULL) || (diagHandler != NULL)) ? LIN_DIAG_RESPONSE : LIN_DIAG_IDLE;
+  else
+    diagState = LIN_DIAG_IDLE;
+
+} // LIN_Schedule::checkDiagnostic()
+
+
+
+/**
+  \brief      Check condition of rule
+  \details    Extract signal (little-endian, bit 0 = LSB of data byte 0) and compare it. A signal beyond the
+              received data never matches.
+  \param[in]  Rule        rule to check
+  \param[in]  numData     number of data bytes
+  \param[in]  data        data bytes
+  \return     true if condition is met
+*/
+bool LIN_Schedule::checkRule(const LIN_schedule_rule_t *Rule, uint8_t numData, uint8_t *data)
+{
+  uint32_t  value = 0;
+  uint8_t   bit;
+
+  // signal not contained in frame
+  if ((Rule->length == 0) || (Rule->length > 32) || ((uint16_t) Rule->startBit + Rule->length > 8 * numData))
+    return false;
+
+  // extract signal
+  for (uint8_t i=0; i<Rule->length; i++)
+  {
+    bit = Rule->startBit + i;
+    if (data[bit >> 3] & (1 << (bit & 0x07)))
+      value |= (uint32_t) 1 << i;
+  }
+
+  // compare
+  switch (Rule->op)
+  {
+    case LIN_RULE_EQ:   return (value == Rule->value);
+    case LIN_RULE_NE:   return (value != Rule->value);
+    case LIN_RULE_GT:   return (value >  Rule->value);
+    case LIN_RULE_LT:   return (value <  Rule->value);
+    case LIN_RULE_ANY:  return ((value & Rule->value) != 0);
+    default:            return false;
+  }
+
+} // LIN_Schedule::checkRule()
+
+
+
+/**
+  \brief      Start a LIN frame
+  \details    Start a master request or slave response frame via LIN master.
+  \param[in]  type        LIN_MASTER_REQUEST or LIN_SLAVE_RESPONSE
+  \param[in]  id          frame ID (unprotected)
+  \param[in]  numData     number of data bytes
+  \param[in]  data        Tx data or Rx buffer. NULL (and no handler) = use registry of LIN master
+  \param[in]  handler     optional callback for slave response
+  \return     result of LIN master
+*/
+LIN_error_t LIN_Schedule::runFrame(LIN_frame_t type, uint8_t id, uint8_t numData, uint8_t *data, decoder_t handler)
+{
+  // master request. W/o data use registry of LIN master
+  if (type == LIN_MASTER_REQUEST)
+    return (data != NULL) ? pLIN->sendMasterRequest(id, numData, data) : pLIN->sendMasterRequest(id);
+
+  // slave response w/o buffer and callback -> dispatch via registry of LIN master, if attached
+  if ((handler == NULL) && (data == NULL) && (pLIN->getRegistry() != NULL))
+    return pLIN->receiveSlaveResponse(id);
+
+  // slave response with callback
+  if (handler != NULL)
+    return pLIN->receiveSlaveResponse(id, numData, handler);
+
+  // slave response with copy to buffer
+  return pLIN->receiveSlaveResponse(id, numData, data);
+
+} // LIN_Schedule::runFrame()
@@ -0,0 +1,184 @@
+/**
+  \file     LIN_schedule.h
+  \brief    Schedule table for LIN master emulation
+  \details  This library provides a schedule table for a LIN_Master. Application frames are executed
+            slot by slot, and diagnostic frames (MasterReq 0x3C / SlaveResp 0x3D) are interleaved into
+            the running schedule at a configurable ratio. Rules on received signals switch the table or insert
+            frames directly from the receive path.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_SCHEDULE_H_
+#define _LIN_SCHEDULE_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_ID_MASTER_REQ   0x3C        //!< frame ID of diagnostic master request
+#define LIN_ID_SLAVE_RESP   0x3D        //!< frame ID of diagnostic slave response
+#define LIN_SCHEDULE_FILLER 4           //!< depth of queue for low-priority background frames
+#define LIN_SCHEDULE_RULES  16          //!< max. number of reactive rules, see LIN_Schedule::setRules()
+#define LIN_SCHEDULE_RETRY  3           //!< max. repetitions of a failed diagnostic frame
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief entry of schedule table
+*/
+typedef struct {
+    LIN_frame_t       type;         //!< LIN_MASTER_REQUEST or LIN_SLAVE_RESPONSE
+    uint8_t           id;           //!< frame ID (unprotected)
+    uint8_t           numData;      //!< number of data bytes (0..8)
+    uint8_t           *data;        //!< Tx data (master request) or Rx buffer (slave response w/o handler). NULL = use registry
+    decoder_t         handler;      //!< optional callback for slave response. NULL = copy to data
+} LIN_schedule_entry_t;
+
+
+/**
+    \brief condition of reactive schedule rule
+*/
+typedef enum {
+    LIN_RULE_EQ       = 0,          //!< signal == value
+    LIN_RULE_NE       = 1,          //!< signal != value
+    LIN_RULE_GT       = 2,          //!< signal > value
+    LIN_RULE_LT       = 3,          //!< signal < value
+    LIN_RULE_ANY      = 4           //!< any bit of value set in signal
+} LIN_rule_op_t;
+
+
+/**
+    \brief action of reactive schedule rule
+*/
+typedef enum {
+    LIN_RULE_SWITCH   = 0,          //!< switch to schedule table entries
+    LIN_RULE_INSERT   = 1           //!< insert frames entries once before next application slots
+} LIN_rule_action_t;
+
+
+/**
+    \brief reactive schedule rule, see LIN_Schedule::setRules()
+*/
+typedef struct {
+    uint8_t           id;           //!< frame ID (unprotected) carrying the signal
+    uint8_t           startBit;     //!< position of signal LSB in frame (0..63)
+    uint8_t           length;       //!< signal length in bits (1..32)
+    LIN_rule_op_t     op;           //!< condition
+    uint32_t          value;        //!< value to compare signal with
+    LIN_rule_action_t action;       //!< action if condition becomes true
+    const LIN_schedule_entry_t *entries;  //!< new schedule table or frames to insert
+    uint8_t           numEntries;   //!< number of entries
+} LIN_schedule_rule_t;
+
+
+/**
+    \brief state of diagnostic channel
+*/
+typedef enum {
+    LIN_DIAG_IDLE     = 0,          //!< no diagnostic frame pending
+    LIN_DIAG_REQUEST  = 1,          //!< master request 0x3C pending
+    LIN_DIAG_RESPONSE = 2           //!< slave response 0x3D pending
+} LIN_diag_state_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  LIN schedule table
+
+  \details Schedule table for a LIN_Master. Call tick() once per slot, e.g. via task scheduler.
+           Queued diagnostic frames are inserted after every diagRatio application slots, so
+           application frames keep running during diagnostics or flashing. Low-priority background frames
+           are sent via idle() in the remaining time of a slot.
+           Reactive rules (see setRules()) are evaluated on each received frame and switch the table or insert frames
+           in the next slot, i.e. without waiting for the application to poll the result.
+*/
+class LIN_Schedule
+{
+  protected:
+
+    // internal variables
+    LIN_Master                  *pLIN;                                      //!< pointer to LIN master
+    const LIN_schedule_entry_t  *table;                                     //!< application schedule table
+    uint8_t                     numEntries;                                 //!< number of entries in table
+    uint8_t                     idxEntry;                                   //!< next application entry
+    uint8_t                     diagRatio;                                  //!< application slots between diagnostic slots
+    uint8_t                     countApp;                                   //!< application slots since last diagnostic slot
+    volatile LIN_diag_state_t   diagState;                                  //!< state of diagnostic channel
+    uint8_t                     diagRequest[8];                             //!< pending diagnostic master request
+    uint8_t                     *diagResponse;                              //!< buffer for diagnostic slave response
+    decoder_t                   diagHandler;                                //!< callback for diagnostic slave response
+    LIN_callback_t              diagCallback;                               //!< context callback for diagnostic slave response
+    void                        *diagContext;                               //!< context pointer passed to diagCallback
+    bool                        diagWait;                                   //!< diagnostic frame started, result not yet checked
+    uint8_t                     seqDiag;                                    //!< result sequence of LIN master before diagnostic frame
+    uint8_t                     diagRetry;                                  //!< repetitions of current diagnostic frame
+    volatile bool               diagFailed;                                 //!< last diagnostic transfer was dropped after max. retries
+    uint16_t                    slotTime;                                   //!< slot time [ms], 0 = unknown (no background frames)
+    uint32_t                    tSlotStart;                                 //!< start of current slot [us]
+    LIN_schedule_entry_t        filler[LIN_SCHEDULE_FILLER];                //!< queue of low-priority background frames
+    volatile uint8_t            headFiller;                                 //!< background queue write index
+    volatile uint8_t            tailFiller;                                 //!< background queue read index
+    const LIN_schedule_rule_t   *rules;                                     //!< reactive rules, or NULL
+    uint8_t                     numRules;                                   //!< number of reactive rules
+    uint16_t                    ruleState;                                  //!< bitmask of rules with true condition
+    volatile uint16_t           ruleTriggered;                              //!< bitmask of rules triggered since getTriggered()
+    const LIN_schedule_entry_t  *nextTable;                                 //!< table to switch to in next slot
+    uint8_t                     numNext;                                    //!< number of entries in nextTable
+    volatile bool               switchPending;                              //!< switch to nextTable in next slot
+    const LIN_schedule_entry_t  *insertTable;                               //!< frames to insert
+    uint8_t                     numInsert;                                  //!< number of frames to insert
+    volatile uint8_t            idxInsert;                                  //!< next frame to insert
+
+    // internal methods
+    LIN_error_t       runFrame(LIN_frame_t type, uint8_t id, uint8_t numData, uint8_t *data, decoder_t handler);  //!< start a LIN frame
+    void              runDiagnostic(void);                                  //!< execute a diagnostic slot
+    void              checkDiagnostic(void);                                //!< advance diagnostic channel after frame result
+    static bool       checkRule(const LIN_schedule_rule_t *Rule, uint8_t numData, uint8_t *data);  //!< check condition of rule
+
+  public:
+
+    // public methods
+    LIN_Schedule(LIN_Master &Lin);                                          //!< class constructor
+    void              setTable(const LIN_schedule_entry_t *Table, uint8_t NumEntries);  //!< set application schedule table
+    void              setDiagnosticRatio(uint8_t Ratio);                    //!< set application slots between diagnostic slots
+    LIN_error_t       queueDiagnostic(const uint8_t *request, uint8_t *response, decoder_t handler=NULL);  //!< queue diagnostic request (+ response)
+    LIN_error_t       queueDiagnosticResponse(LIN_callback_t Callback, void *Context);  //!< queue diagnostic response poll w/o request
+    bool              diagnosticPending(void);                              //!< check if diagnostic frame is pending
+    bool              diagnosticFailed(void);                               //!< check if last diagnostic transfer failed
+    void              tick(void);                                           //!< execute next slot
+    void              setSlotTime(uint16_t SlotTime);                       //!< set slot time for background frames
+    bool              queueBackground(const LIN_schedule_entry_t &Frame);   //!< queue low-priority background frame
+    bool              backgroundPending(void);                              //!< check if background frames are queued
+    void              idle(void);                                           //!< send background frame if slot time suffices
+    void              setRules(const LIN_schedule_rule_t *Rules, uint8_t Num);  //!< set reactive rules. Use NULL to remove
+    void              evaluate(uint8_t id, uint8_t numData, uint8_t *data); //!< evaluate rules for received frame
+    uint16_t          getTriggered(void);                                   //!< get and clear triggered rules
+    static void       ruleHook(void *Context, uint8_t id, uint8_t numData, uint8_t *data);  //!< frame hook for LIN_Master
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_SCHEDULE_H_
@@ -0,0 +1,290 @@
+/**
+  \file     LIN_trace.cpp
+  \brief    Execution trace for LIN master emulation
+  \details  This library records state transitions of each LIN_Master, handler and callback execution spans
+            and schedule ticks in a ring buffer, and exports them in Chrome trace JSON format. Save the output
+            to a .json file and open it in https://ui.perfetto.dev or chrome://tracing.
+            Recording is only compiled in if LIN_TRACE != 0, see LIN_trace.h.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_master.h"
+#include "LIN_trace.h"
+#include "LIN_atomic.h"
+#include "LIN_clock.h"
+
+// only compile if trace is enabled
+#if (LIN_TRACE != 0)
+
+
+/// global trace instance
+LIN_Trace     LIN_trace;
+
+
+/**
+  \brief      Print start of a Chrome trace event
+  \details    Print separator and common fields of a Chrome trace event. Caller adds specific fields and closing brace.
+  \param[in]  Out         output stream
+  \param[in]  First       true for first event (no separator). Is cleared
+  \param[in]  Name        event name
+  \param[in]  Phase       event phase, e.g. "X" for complete event
+  \param[in]  Tid         track ID
+*/
+static void printEvent(Print &Out, bool &First, const char *Name, const char *Phase, uint8_t Tid)
+{
+  if (!First)
+    Out.println(",");
+  First = false;
+  Out.print("{\"name\":\""); Out.print(Name);
+  Out.print("\",\"ph\":\"");  Out.print(Phase);
+  Out.print("\",\"pid\":1,\"tid\":"); Out.print(Tid);
+
+} // printEvent()
+
+
+
+/**
+  \brief      Print timestamp of a Chrome trace event
+  \details    Print timestamp as base + relative time. Arduino Print has no 64 bit support, so print as 2 parts.
+  \param[in]  Out         output stream
+  \param[in]  Base        host time of oldest event, or 0 for relative timestamps [us]
+  \param[in]  Ts          time relative to oldest event [us]
+*/
+static void printTime(Print &Out, uint64_t Base, uint32_t Ts)
+{
+  uint64_t  t = Base + Ts;
+  uint32_t  low;
+
+  // print upper digits, then lower 9 digits with leading zeros
+  if (t >= 1000000000ULL)
+  {
+    Out.print((uint32_t) (t / 1000000000ULL));
+    low = (uint32_t) (t % 1000000000ULL);
+    for (uint32_t d=100000000L; d>1; d/=10)
+    {
+      if (low < d)
+        Out.print('0');
+      else
+        break;
+    }
+    Out.print(low);
+  }
+  else
+    Out.print((uint32_t) t);
+
+} // printTime()
+
+
+
+/**
+  \brief      Constructor for trace recorder
+  \details    Constructor for trace recorder. Recording is enabled.
+*/
+LIN_Trace::LIN_Trace()
+{
+  // no LIN masters registered yet
+  for (uint8_t i=0; i<LIN_TRACE_BUSES; i++)
+    buses[i] = NULL;
+  clock = NULL;
+
+  // empty buffer and start recording
+  clear();
+  enabled = true;
+
+} // LIN_Trace::LIN_Trace()
+
+
+
+/**
+  \brief      Get index of LIN master
+  \details    Get trace index of a LIN master. On first call the master is registered. Called by LIN_Master::begin().
+  \param[in]  Bus         LIN master instance
+  \return     index of LIN master, or LIN_TRACE_BUSES if too many masters are traced
+*/
+uint8_t LIN_Trace::registerBus(const void *Bus)
+{
+  for (uint8_t i=0; i<LIN_TRACE_BUSES; i++)
+  {
+    if (buses[i] == Bus)
+      return i;
+    if (buses[i] == NULL)
+    {
+      buses[i] = Bus;
+      return i;
+    }
+  }
+  return LIN_TRACE_BUSES;
+
+} // LIN_Trace::registerBus()
+
+
+
+/**
+  \brief      Record trace event
+  \details    Record trace event with current timestamp. If buffer is full the oldest event is overwritten.
+  \param[in]  Type        event type, see LIN_trace_type_t
+  \param[in]  Bus         index of LIN master
+  \param[in]  Value       event specific value
+*/
+void LIN_Trace::record(uint8_t Type, uint8_t Bus, uint8_t Value)
+{
+  LIN_trace_event_t  *event;
+  LIN_irq_t          s;
+
+  // recording stopped, e.g. during export
+  if (!enabled)
+    return;
+
+  // store event. Mask interrupts only for buffer update
+  s = LIN_irqSave();
+  event = &(buf[head]);
+  event->time  = micros();
+  event->type  = Type;
+  event->bus   = Bus;
+  event->value = Value;
+  head = (head + 1) % LIN_TRACE_DEPTH;
+  if (num < LIN_TRACE_DEPTH)
+    num++;
+  LIN_irqRestore(s);
+
+} // LIN_Trace::record()
+
+
+
+/**
+  \brief      Delete recorded events
+  \details    Delete all recorded events.
+*/
+void LIN_Trace::clear(void)
+{
+  LIN_irq_t  s = LIN_irqSave();
+  head = 0;
+  num  = 0;
+  LIN_irqRestore(s);
+
+} // LIN_Trace::clear()
+
+
+
+/**
+  \brief      Set host clock for export
+  \details    Export timestamps in host time via clock correlation, see LIN_clock.h. Then the trace can be merged
+              with host-side logs. Without clock or before first sync, timestamps are relative to the oldest event.
+  \param[in]  Clock       host clock correlation, or NULL for relative timestamps
+*/
+void LIN_Trace::setClock(LIN_ClockSync *Clock)
+{
+  clock = Clock;
+
+} // LIN_Trace::setClock()
+
+
+
+/**
+  \brief      Export recorded events in Chrome trace format
+  \details    Print recorded events as Chrome trace JSON, then clear buffer. Each LIN master gets a track with its
+              BREAK and FRAME phases and a CPU track with handler and callback spans. Schedule ticks are shown as
+              instant events on a common track. Recording is paused during export.
+  \param[in]  Out         output stream, e.g. Serial
+*/
+void LIN_Trace::printChromeTrace(Print &Out)
+{
+  LIN_trace_event_t  *event;
+  uint32_t           t0, ts;
+  uint64_t           base = 0;
+  uint32_t           tState[LIN_TRACE_BUSES];
+  uint8_t            state[LIN_TRACE_BUSES];
+  uint8_t            idx;
+  bool               first = true;
+
+  // pause recording for consistent buffer
+  enabled = false;
+
+  // track names
+  Out.println("{\"traceEvents\":[");
+  for (uint8_t i=0; (i<LIN_TRACE_BUSES) && (buses[i] != NULL); i++)
+  {
+    printEvent(Out, first, "thread_name", "M", 10*i+1);
+    Out.print(",\"args\":{\"name\":\"LIN bus "); Out.print(i); Out.print("\"}}");
+    printEvent(Out, first, "thread_name", "M", 10*i+2);
+    Out.print(",\"args\":{\"name\":\"LIN bus "); Out.print(i); Out.print(" CPU\"}}");
+    state[i] = 0;
+    tState[i] = 0;
+  }
+  printEvent(Out, first, "thread_name", "M", 100);
+  Out.print(",\"args\":{\"name\":\"scheduler\"}}");
+
+  // loop over events from oldest to newest. Timestamps relative to oldest event, with optional host time offset
+  // and drift correction
+  idx = (head + LIN_TRACE_DEPTH - num) % LIN_TRACE_DEPTH;
+  t0  = buf[idx].time;
+  if ((clock != NULL) && (clock->isSynced()))
+    base = clock->toHost(t0);
+  for (uint8_t n=0; n<num; n++, idx=(idx+1)%LIN_TRACE_DEPTH)
+  {
+    event = &(buf[idx]);
+    ts    = (base != 0) ? (uint32_t) (clock->toHost(event->time) - base) : event->time - t0;
+
+    // schedule tick
+    if (event->type == LIN_TRACE_TICK)
+    {
+      printEvent(Out, first, "tick", "i", 100);
+      Out.print(",\"s\":\"t\",\"ts\":"); printTime(Out, base, ts);
+      Out.print(",\"args\":{\"entry\":"); Out.print(event->value); Out.print("}}");
+      continue;
+    }
+
+    // ignore events of unregistered masters
+    if (event->bus >= LIN_TRACE_BUSES)
+      continue;
+
+    // state transition -> close previous BREAK or FRAME phase as complete event
+    if (event->type == LIN_TRACE_STATE)
+    {
+      if ((state[event->bus] == LIN_STATE_BREAK) || (state[event->bus] == LIN_STATE_FRAME))
+      {
+        printEvent(Out, first, (state[event->bus] == LIN_STATE_BREAK) ? "BREAK" : "FRAME", "X", 10*event->bus+1);
+        Out.print(",\"ts\":"); printTime(Out, base, tState[event->bus]);
+        Out.print(",\"dur\":"); Out.print(ts - tState[event->bus]); Out.print("}");
+      }
+      state[event->bus]  = event->value;
+      tState[event->bus] = ts;
+    }
+
+    // handler span on CPU track
+    else if (event->type == LIN_TRACE_HANDLER_BEGIN)
+    {
+      printEvent(Out, first, (event->value == 0) ? "handlerSend" : "handlerReceive", "B", 10*event->bus+2);
+      Out.print(",\"ts\":"); printTime(Out, base, ts); Out.print("}");
+    }
+
+    // callback span on CPU track, nested in receive handler
+    else if (event->type == LIN_TRACE_CALLBACK_BEGIN)
+    {
+      printEvent(Out, first, (event->value == 0) ? "callback" : "frameHook", "B", 10*event->bus+2);
+      Out.print(",\"ts\":"); printTime(Out, base, ts); Out.print("}");
+    }
+
+    // end of handler or callback span
+    else if ((event->type == LIN_TRACE_HANDLER_END) || (event->type == LIN_TRACE_CALLBACK_END))
+    {
+      printEvent(Out, first, "", "E", 10*event->bus+2);
+      Out.print(",\"ts\":"); printTime(Out, base, ts); Out.print("}");
+    }
+
+  } // loop over events
+
+  Out.println();
+  Out.println("],\"displayTimeUnit\":\"ms\"}");
+
+  // restart recording
+  clear();
+  enabled = true;
+
+} // LIN_Trace::printChromeTrace()
+
+#endif // LIN_TRACE
@@ -0,0 +1,116 @@
+/**
+  \file     LIN_trace.h
+  \brief    Execution trace for LIN master emulation
+  \details  This library records state transitions of each LIN_Master, handler and callback execution spans
+            and schedule ticks in a ring buffer, and exports them in Chrome trace JSON format. Save the output
+            to a .json file and open it in https://ui.perfetto.dev or chrome://tracing.
+            Recording is only compiled in if LIN_TRACE != 0, set below or via build flag -DLIN_TRACE=1.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_TRACE_H_
+#define _LIN_TRACE_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#ifndef LIN_TRACE
+  #define LIN_TRACE         0           //!< record execution trace (0=off, 1=on)
+#endif
+#define LIN_TRACE_DEPTH     64          //!< number of recorded events (8B each)
+#define LIN_TRACE_BUSES     4           //!< max. number of traced LIN masters
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+
+// forward declaration of optional host clock correlation
+class LIN_ClockSync;
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief type of trace event
+*/
+typedef enum {
+    LIN_TRACE_STATE          = 1,   //!< LIN master state transition. value = new state
+    LIN_TRACE_HANDLER_BEGIN  = 2,   //!< start of send (value=0) or receive (value=1) handler
+    LIN_TRACE_HANDLER_END    = 3,   //!< end of handler
+    LIN_TRACE_CALLBACK_BEGIN = 4,   //!< start of receive callback (value=0) or frame hook (value=1)
+    LIN_TRACE_CALLBACK_END   = 5,   //!< end of callback
+    LIN_TRACE_TICK           = 6    //!< schedule tick. value = table entry, 0xFF = diagnostic slot, 0xFE = inserted frame
+} LIN_trace_type_t;
+
+
+/**
+    \brief trace event
+*/
+typedef struct {
+    uint32_t          time;         //!< timestamp [us]
+    uint8_t           type;         //!< event type, see LIN_trace_type_t
+    uint8_t           bus;          //!< index of LIN master, see LIN_Trace::registerBus()
+    uint8_t           value;        //!< event specific value
+} LIN_trace_event_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Execution trace recorder
+
+  \details Ring buffer of trace events. Recording is safe from loop() and task scheduler callbacks. When full, the
+           oldest events are overwritten, i.e. the trace covers the last LIN_TRACE_DEPTH events.
+*/
+class LIN_Trace
+{
+  protected:
+
+    // internal variables
+    LIN_trace_event_t buf[LIN_TRACE_DEPTH];                                 //!< event ring buffer
+    uint8_t           head;                                                 //!< index of next event
+    uint8_t           num;                                                  //!< number of recorded events
+    volatile bool     enabled;                                              //!< recording enabled
+    const void        *buses[LIN_TRACE_BUSES];                              //!< registered LIN masters
+    LIN_ClockSync     *clock;                                               //!< optional host clock for export, or NULL
+
+  public:
+
+    // public methods
+    LIN_Trace();                                                            //!< class constructor
+    uint8_t           registerBus(const void *Bus);                         //!< get index of LIN master
+    void              record(uint8_t Type, uint8_t Bus, uint8_t Value);     //!< record event
+    void              clear(void);                                          //!< delete recorded events
+    void              setClock(LIN_ClockSync *Clock);                       //!< export timestamps in host time. NULL for relative
+    void              printChromeTrace(Print &Out);                         //!< export events in Chrome trace format
+};
+
+
+// global trace instance and recording macro. Without LIN_TRACE recording costs nothing
+#if (LIN_TRACE != 0)
+  extern LIN_Trace  LIN_trace;
+  #define LIN_TRACE_EVENT(Type, Bus, Value)   LIN_trace.record(Type, Bus, Value)
+#else
+  #define LIN_TRACE_EVENT(Type, Bus, Value)
+#endif
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_TRACE_H_
@@ -0,0 +1,476 @@
+/**
+  \file     LIN_vm.cpp
+  \brief    Bytecode interpreter for LIN test sequences
+  \details  This library executes compact test sequences (send/receive frames, wait, compare signals, branch, loop,
+            record results) against a LIN_Master on the board. Sequences are loaded over Serial or from memory,
+            i.e. steps run at bus speed instead of waiting for a PC round trip per step.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+// include files
+#include "Arduino.h"
+#include "LIN_vm.h"
+
+
+/**
+  \brief      Constructor for interpreter
+  \details    Constructor for interpreter. No sequence is loaded.
+  \param[in]  Lin         LIN master under test. Must be started via begin()
+*/
+LIN_VM::LIN_VM(LIN_Master &Lin)
+{
+  pLIN      = &Lin;
+  lenCode   = 0;
+  seqFrame  = 0;
+  idFrame   = 0;
+  posLoad   = 0;
+  numResult = 0;
+  stop();
+
+} // LIN_VM::LIN_VM()
+
+
+
+/**
+  \brief      Load sequence from memory
+  \details    Copy sequence to internal buffer. A running sequence is stopped.
+  \param[in]  Code        sequence, see LIN_vm_op_t
+  \param[in]  Len         length of sequence [B]
+  \return     false if sequence exceeds LIN_VM_CODE
+*/
+bool LIN_VM::load(const uint8_t *Code, uint16_t Len)
+{
+  stop();
+  if (Len > LIN_VM_CODE)
+    return false;
+  memcpy(code, Code, Len);
+  lenCode = Len;
+  return true;
+
+} // LIN_VM::load()
+
+
+
+/**
+  \brief      Load sequence over serial link
+  \details    Non-blocking loader. Reads available bytes of 'L', length (u16), code and 8 bit sum of code.
+              A running sequence is stopped when a new sequence starts. Bytes before 'L' are ignored.
+  \param[in]  In          serial link, e.g. Serial
+  \return     1 if sequence was loaded, -1 on length or checksum error, 0 if incomplete
+*/
+int8_t LIN_VM::receive(Stream &In)
+{
+  int  c;
+
+  while ((c = In.read()) >= 0)
+  {
+    // wait for start of sequence
+    if (posLoad == 0)
+    {
+      if (c == 'L')
+      {
+        stop();
+        posLoad = 1;
+      }
+    }
+
+    // length
+    else if (posLoad == 1)
+    {
+      lenLoad = (uint8_t) c;
+      posLoad = 2;
+    }
+    else if (posLoad == 2)
+    {
+      lenLoad |= (uint16_t) c << 8;
+      sumLoad  = 0;
+      lenCode  = 0;
+      posLoad  = 3;
+      if (lenLoad > LIN_VM_CODE)
+      {
+        posLoad = 0;
+        return -1;
+      }
+    }
+
+    // code
+    else if (posLoad < 3 + lenLoad)
+    {
+      code[posLoad-3] = (uint8_t) c;
+      sumLoad += (uint8_t) c;
+      posLoad++;
+    }
+
+    // checksum
+    else
+    {
+      posLoad = 0;
+      if ((uint8_t) c != sumLoad)
+        return -1;
+      lenCode = lenLoad;
+      return 1;
+    }
+  }
+
+  return 0;
+
+} // LIN_VM::receive()
+
+
+
+/**
+  \brief      Start sequence
+  \details    Start loaded sequence at address 0. Recorded results and registers are cleared.
+*/
+void LIN_VM::start(void)
+{
+  stop();
+  numResult = 0;
+  for (uint8_t i=0; i<LIN_VM_REGS; i++)
+    reg[i] = 0;
+  memset(rx, 0, 8);
+  flag      = false;
+  lastError = LIN_SUCCESS;
+  tStart    = micros();
+  tMark     = tStart;
+  state     = (lenCode > 0) ? LIN_VM_RUN : LIN_VM_FAIL;
+
+} // LIN_VM::start()
+
+
+
+/**
+  \brief      Stop sequence
+  \details    Stop sequence. A pending frame is not aborted.
+*/
+void LIN_VM::stop(void)
+{
+  state   = LIN_VM_IDLE;
+  pc      = 0;
+  busy    = false;
+  waiting = false;
+
+} // LIN_VM::stop()
+
+
+
+/**
+  \brief      Run sequence
+  \details    Execute up to LIN_VM_STEPS instructions. Returns early while a frame or wait is pending.
+              Call from loop() until false is returned.
+  \return     true while sequence is running
+*/
+bool LIN_VM::task(void)
+{
+  LIN_result_t  res;
+
+  if (state != LIN_VM_RUN)
+    return false;
+
+  // frame pending -> wait for completion, then store its error
+  if (busy)
+  {
+    if (pLIN->getState() != LIN_STATE_IDLE)
+      return true;
+    busy = false;
+
+    // result of other frame, i.e. own result was overwritten -> error and discard possibly stale response
+    if ((pLIN->getResult(res) != (uint8_t) (seqFrame + 2)) || (res.id != idFrame))
+    {
+      lastError = LIN_ERROR_STATE;
+      memset(rx, 0, 8);
+    }
+    else
+      lastError = res.error;
+  }
+
+  // execute instructions until one has to wait
+  for (uint8_t i=0; (i<LIN_VM_STEPS) && (state == LIN_VM_RUN); i++)
+  {
+    if (!step())
+      break;
+  }
+
+  return (state == LIN_VM_RUN);
+
+} // LIN_VM::task()
+
+
+
+/**
+  \brief      Get state of interpreter
+  \details    Get state of interpreter.
+  \return     state of interpreter
+*/
+LIN_vm_state_t LIN_VM::getState(void)
+{
+  return state;
+
+} // LIN_VM::getState()
+
+
+
+/**
+  \brief      Print recorded results
+  \details    Print one line "code,flag,error,time[us]" per recorded result.
+  \param[in]  Out         output stream, e.g. Serial
+*/
+void LIN_VM::printResults(Print &Out)
+{
+  for (uint8_t i=0; i<numResult; i++)
+  {
+    Out.print(result[i].code);  Out.print(',');
+    Out.print(result[i].flag);  Out.print(',');
+    Out.print(result[i].error); Out.print(',');
+    Out.println(result[i].time);
+  }
+
+} // LIN_VM::printResults()
+
+
+
+/**
+  \brief      Check operands
+  \details    Check that num operand bytes follow the current opcode, else stop sequence.
+  \param[in]  num         number of operand bytes
+  \return     true if operands are complete
+*/
+bool LIN_VM::fetch(uint8_t num)
+{
+  if (pc + 1 + num > lenCode)
+  {
+    state = LIN_VM_FAIL;
+    return false;
+  }
+  return true;
+
+} // LIN_VM::fetch()
+
+
+
+/**
+  \brief      Read u16 operand
+  \details    Read little endian u16 operand.
+  \param[in]  addr        address of operand
+  \return     operand
+*/
+uint16_t LIN_VM::get16(uint16_t addr)
+{
+  return (uint16_t) code[addr] | ((uint16_t) code[addr+1] << 8);
+
+} // LIN_VM::get16()
+
+
+
+/**
+  \brief      Read u32 operand
+  \details    Read little endian u32 operand.
+  \param[in]  addr        address of operand
+  \return     operand
+*/
+uint32_t LIN_VM::get32(uint16_t addr)
+{
+  return (uint32_t) get16(addr) | ((uint32_t) get16(addr+2) << 16);
+
+} // LIN_VM::get32()
+
+
+
+/**
+  \brief      Read signal from rx buffer
+  \details    Read little endian signal from data of last slave response, like LIN_Frame::getSignal().
+  \param[in]  startBit    position of LSB (0..63)
+  \param[in]  length      signal length (1..32)
+  \return     signal value
+*/
+uint32_t LIN_VM::signal(uint8_t startBit, uint8_t length)
+{
+  uint32_t  value = 0;
+  uint8_t   bit;
+
+  for (uint8_t i=0; (i<length) && (i<32); i++)
+  {
+    bit = startBit + i;
+    if (bit >= 64)
+      break;
+    if (rx[bit >> 3] & (1 << (bit & 0x07)))
+      value |= (uint32_t) 1 << i;
+  }
+  return value;
+
+} // LIN_VM::signal()
+
+
+
+/**
+  \brief      Execute one instruction
+  \details    Execute instruction at pc. Frames are only started if the LIN master is idle, i.e. a running schedule
+              frame is not aborted.
+  \return     true if next instruction can be executed immediately, false if waiting or stopped
+*/
+bool LIN_VM::step(void)
+{
+  uint8_t      op, num;
+  uint16_t     addr;
+  LIN_error_t  res;
+  LIN_result_t last;
+
+  // end of code w/o END
+  if (pc >= lenCode)
+  {
+    state = LIN_VM_FAIL;
+    return false;
+  }
+
+  op = code[pc];
+  switch (op)
+  {
+    // end of sequence
+    case LIN_VM_END:
+      state = LIN_VM_DONE;
+      return false;
+
+    // send master request or receive slave response. Completion is checked in task()
+    case LIN_VM_SEND:
+    case LIN_VM_RECV:
+      if (!fetch(2))
+        return false;
+      num = code[pc+2];
+      if ((num > 8) || ((op == LIN_VM_SEND) && (!fetch(2+num))))
+      {
+        state = LIN_VM_FAIL;
+        return false;
+      }
+      if (pLIN->getState() != LIN_STATE_IDLE)
+        return false;
+      seqFrame = pLIN->getResult(last);                  // result sequence before frame, see task()
+      idFrame  = code[pc+1] & 0x3F;
+      if (op == LIN_VM_SEND)
+      {
+        res = pLIN->sendMasterRequest(code[pc+1], num, code+pc+3);
+        pc += 3 + num;
+      }
+      else
+      {
+        memset(rx, 0, 8);
+        res = pLIN->receiveSlaveResponse(code[pc+1], num, rx);
+        pc += 3;
+      }
+      lastError = res;
+      busy      = (res == LIN_SUCCESS);
+      return false;
+
+    // wait relative to now or to time reference
+    case LIN_VM_WAIT:
+    case LIN_VM_AT:
+      if (!fetch(4))
+        return false;
+      if (!waiting)
+      {
+        tWait   = ((op == LIN_VM_WAIT) ? micros() : tMark) + get32(pc+1);
+        waiting = true;
+      }
+      if ((int32_t) (micros() - tWait) < 0)
+        return false;
+      waiting = false;
+      pc += 5;
+      return true;
+
+    // set time reference
+    case LIN_VM_MARK:
+      tMark = micros();
+      pc += 1;
+      return true;
+
+    // compare signal with value
+    case LIN_VM_CMP:
+      if (!fetch(6))
+        return false;
+      flag = (signal(code[pc+1], code[pc+2]) == get32(pc+3));
+      pc += 7;
+      return true;
+
+    // compare signal with range
+    case LIN_VM_RANGE:
+      if (!fetch(10))
+        return false;
+      {
+        uint32_t  value = signal(code[pc+1], code[pc+2]);
+        flag = ((value >= get32(pc+3)) && (value <= get32(pc+7)));
+      }
+      pc += 11;
+      return true;
+
+    // check error of last frame
+    case LIN_VM_OK:
+      flag = (lastError == LIN_SUCCESS);
+      pc += 1;
+      return true;
+
+    // jumps
+    case LIN_VM_JMP:
+    case LIN_VM_JT:
+    case LIN_VM_JF:
+      if (!fetch(2))
+        return false;
+      addr = get16(pc+1);
+      if (addr >= lenCode)
+      {
+        state = LIN_VM_FAIL;
+        return false;
+      }
+      if ((op == LIN_VM_JMP) || ((op == LIN_VM_JT) && flag) || ((op == LIN_VM_JF) && !flag))
+        pc = addr;
+      else
+        pc += 3;
+      return true;
+
+    // set loop register
+    case LIN_VM_SET:
+      if ((!fetch(3)) || (code[pc+1] >= LIN_VM_REGS))
+      {
+        state = LIN_VM_FAIL;
+        return false;
+      }
+      reg[code[pc+1]] = get16(pc+2);
+      pc += 4;
+      return true;
+
+    // decrement loop register and jump if not zero
+    case LIN_VM_LOOP:
+      if ((!fetch(3)) || (code[pc+1] >= LIN_VM_REGS) || (get16(pc+2) >= lenCode))
+      {
+        state = LIN_VM_FAIL;
+        return false;
+      }
+      if ((reg[code[pc+1]] > 0) && (--reg[code[pc+1]] > 0))
+        pc = get16(pc+2);
+      else
+        pc += 4;
+      return true;
+
+    // record result. Further results are dropped if buffer is full
+    case LIN_VM_RESULT:
+      if (!fetch(1))
+        return false;
+      if (numResult < LIN_VM_RESULTS)
+      {
+        result[numResult].code  = code[pc+1];
+        result[numResult].flag  = flag;
+        result[numResult].error = lastError;
+        result[numResult].time  = micros() - tStart;
+        numResult++;
+      }
+      pc += 2;
+      return true;
+
+    // invalid opcode
+    default:
+      state = LIN_VM_FAIL;
+      return false;
+
+  } // switch (op)
+
+} // LIN_VM::step()
@@ -0,0 +1,152 @@
+/**
+  \file     LIN_vm.h
+  \brief    Bytecode interpreter for LIN test sequences
+  \details  This library executes compact test sequences (send/receive frames, wait, compare signals, branch, loop,
+            record results) against a LIN_Master on the board. Sequences are loaded over Serial or from memory,
+            i.e. steps run at bus speed instead of waiting for a PC round trip per step.
+  \author   Georg Icking-Konert
+  \date     2026-10-19
+  \version  0.1
+*/
+
+/*-----------------------------------------------------------------------------
+  MODULE DEFINITION FOR MULTIPLE INCLUSION
+-----------------------------------------------------------------------------*/
+#ifndef _LIN_VM_H_
+#define _LIN_VM_H_
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL DEFINES
+-----------------------------------------------------------------------------*/
+
+#define LIN_VM_CODE         256         //!< max. size of sequence [B]
+#define LIN_VM_RESULTS      16          //!< max. number of recorded results
+#define LIN_VM_REGS         4           //!< number of loop registers
+#define LIN_VM_STEPS        16          //!< max. instructions per task() call
+
+
+/*-----------------------------------------------------------------------------
+  INCLUDE FILES
+-----------------------------------------------------------------------------*/
+
+// include required libs
+#include "Arduino.h"
+#include "LIN_master.h"
+
+
+/*-----------------------------------------------------------------------------
+        GLOBAL ENUMS/STRUCTS
+-----------------------------------------------------------------------------*/
+
+/**
+    \brief opcodes of test sequence. Multi-byte operands are little endian, addresses are absolute
+*/
+typedef enum {
+    LIN_VM_END        = 0x00,       //!< end of sequence
+    LIN_VM_SEND       = 0x01,       //!< send master request: id, n, data[n]
+    LIN_VM_RECV       = 0x02,       //!< receive slave response to rx buffer: id, n
+    LIN_VM_WAIT       = 0x03,       //!< wait: time[us] (u32)
+    LIN_VM_MARK       = 0x04,       //!< set time reference to now
+    LIN_VM_AT         = 0x05,       //!< wait until time reference + time[us] (u32)
+    LIN_VM_CMP        = 0x06,       //!< flag = (rx signal == value): startBit, length, value (u32)
+    LIN_VM_RANGE      = 0x07,       //!< flag = (min <= rx signal <= max): startBit, length, min (u32), max (u32)
+    LIN_VM_OK         = 0x08,       //!< flag = (last frame without error)
+    LIN_VM_JMP        = 0x09,       //!< jump: address (u16)
+    LIN_VM_JT         = 0x0A,       //!< jump if flag: address (u16)
+    LIN_VM_JF         = 0x0B,       //!< jump if not flag: address (u16)
+    LIN_VM_SET        = 0x0C,       //!< set register: reg, value (u16)
+    LIN_VM_LOOP       = 0x0D,       //!< decrement register, jump if not zero: reg, address (u16)
+    LIN_VM_RESULT     = 0x0E        //!< record result: code
+} LIN_vm_op_t;
+
+
+/**
+    \brief state of interpreter
+*/
+typedef enum {
+    LIN_VM_IDLE       = 0,          //!< no sequence started
+    LIN_VM_RUN        = 1,          //!< sequence running
+    LIN_VM_DONE       = 2,          //!< sequence finished with LIN_VM_END
+    LIN_VM_FAIL       = 3           //!< invalid opcode, operand or address
+} LIN_vm_state_t;
+
+
+/**
+    \brief recorded result
+*/
+typedef struct {
+    uint8_t           code;         //!< code of RESULT instruction
+    bool              flag;         //!< flag at RESULT
+    LIN_error_t       error;        //!< error of last frame
+    uint32_t          time;         //!< time since start [us]
+} LIN_vm_result_t;
+
+
+
+/*-----------------------------------------------------------------------------
+  GLOBAL CLASS
+-----------------------------------------------------------------------------*/
+
+/**
+  \brief  Test sequence interpreter
+
+  \details Interpreter for test sequences, see LIN_vm_op_t. Call task() from loop() until it returns false. Each call
+           executes up to LIN_VM_STEPS instructions and returns early while a frame or wait is pending, i.e. other
+           code keeps running. Frames are started as soon as the LIN master is idle, so they may be interleaved with
+           a running schedule. Waits are busy-free and checked with micros().
+           Load over Serial with receive(): 'L', length (u16), code, 8 bit sum of code.
+*/
+class LIN_VM
+{
+  protected:
+
+    // internal variables
+    LIN_Master        *pLIN;                                                //!< LIN master under test
+    uint8_t           code[LIN_VM_CODE];                                    //!< sequence
+    uint16_t          lenCode;                                              //!< length of sequence
+    uint16_t          pc;                                                   //!< address of next instruction
+    LIN_vm_state_t    state;                                                //!< state of interpreter
+    bool              busy;                                                 //!< frame pending
+    uint8_t           seqFrame;                                             //!< result sequence of LIN master before pending frame
+    uint8_t           idFrame;                                              //!< ID of pending frame
+    bool              flag;                                                 //!< result of last compare
+    LIN_error_t       lastError;                                            //!< error of last frame
+    uint8_t           rx[8];                                                //!< data of last slave response
+    uint16_t          reg[LIN_VM_REGS];                                     //!< loop registers
+    uint32_t          tStart;                                               //!< start of sequence [us]
+    uint32_t          tMark;                                                //!< time reference [us]
+    uint32_t          tWait;                                                //!< end of pending wait [us]
+    bool              waiting;                                              //!< wait pending
+    uint16_t          lenLoad;                                              //!< expected length during receive()
+    uint16_t          posLoad;                                              //!< received bytes during receive()
+    uint8_t           sumLoad;                                              //!< sum of received code
+
+    // internal methods
+    bool              fetch(uint8_t num);                                   //!< check that num operand bytes follow
+    uint16_t          get16(uint16_t addr);                                 //!< read u16 operand
+    uint32_t          get32(uint16_t addr);                                 //!< read u32 operand
+    uint32_t          signal(uint8_t startBit, uint8_t length);             //!< read signal from rx buffer
+    bool              step(void);                                           //!< execute one instruction
+
+  public:
+
+    // public variables
+    LIN_vm_result_t   result[LIN_VM_RESULTS];                               //!< recorded results
+    uint8_t           numResult;                                            //!< number of recorded results
+
+    // public methods
+    LIN_VM(LIN_Master &Lin);                                                //!< class constructor
+    bool              load(const uint8_t *Code, uint16_t Len);              //!< load sequence from memory
+    int8_t            receive(Stream &In);                                  //!< load sequence over serial link
+    void              start(void);                                          //!< start sequence
+    void              stop(void);                                           //!< stop sequence
+    bool              task(void);                                           //!< run sequence. Return true while running
+    LIN_vm_state_t    getState(void);                                       //!< get state of interpreter
+    void              printResults(Print &Out);                             //!< print recorded results
+};
+
+/*-----------------------------------------------------------------------------
+    END OF MODULE DEFINITION FOR MULTIPLE INLUSION
+-----------------------------------------------------------------------------*/
+#endif // _LIN_VM_H_